@@ -8,7 +8,7 @@
 #include <wingpackage/path_matcher.hpp>
 #include <wingpackage/make_setup.hpp>
 #include <wingstall_config/config.hpp>
-#include <sngxml/dom/Parser.hpp>
+#include <sngxml/dom/DocumentCache.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/TextUtils.hpp>
 #include <soulng/util/MappedInputFile.hpp>
@@ -88,7 +88,8 @@ void BuildTask::Run()
         log->Clear();
         log->WriteLine("================ Building Package '" + mainWindow->GetPackage()->Name() + "' ================");
         log->WriteLine("Creating package index...");
-        std::unique_ptr<sngxml::dom::Document> packageDoc = sngxml::dom::ReadDocument(mainWindow->GetPackage()->FilePath());
+        std::shared_ptr<sngxml::dom::Document> packageDoc = sngxml::dom::ReadCachedDocument(mainWindow->GetPackage()->FilePath(),
+            sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena | sngxml::dom::Flags::utf8);
         wingpackage::PathMatcher pathMatcher(mainWindow->GetPackage()->FilePath());
         std::unique_ptr<wingpackage::Package> packagePtr(new wingpackage::Package(pathMatcher, packageDoc.get()));
         package = packagePtr.get();
@@ -211,19 +212,23 @@ void BuildTask::MakeCompileBatches(
         throw std::runtime_error("could not create directory '" + compileDirectory + "': " + PlatformStringToUtf8(ec.message()));
     }
 
-    std::unique_ptr<sngxml::dom::Document> configDoc = wingstall::config::ConfigurationDocument();
+    std::shared_ptr<const wingstall::config::ConfigurationSettings> settings = wingstall::config::GetConfigurationSettings();
+    if (!settings)
+    {
+        throw std::runtime_error("could not read configuration document '" + wingstall::config::ConfigFilePath() + "'");
+    }
 
-    std::string vcvars64BatFilePath = wingstall::config::VCVarsFilePath(configDoc.get());
+    std::string vcvars64BatFilePath = settings->vcVarsFilePath;
     if (!boost::filesystem::exists(vcvars64BatFilePath))
     {
         throw std::runtime_error("Visual C++ vcvars64.bat file '" + vcvars64BatFilePath + "' does not exist. Check the configuration.");
     }
-    std::string boostIncludeDir = wingstall::config::BoostIncludeDir(configDoc.get());
+    std::string boostIncludeDir = settings->boostIncludeDir;
     if (!boost::filesystem::exists(boostIncludeDir))
     {
         throw std::runtime_error("Boost include directory '" + boostIncludeDir + "' does not exist. Check the configuration.");
     }
-    std::string boostLibDir = wingstall::config::BoostLibDir(configDoc.get());
+    std::string boostLibDir = settings->boostLibDir;
     if (!boost::filesystem::exists(boostLibDir))
     {
         throw std::runtime_error("Boost library directory '" + boostLibDir + "' does not exist. Check the configuration.");
@@ -17,7 +17,7 @@
 #include <wing/PaddedControl.hpp>
 #include <wing/ScrollableControl.hpp>
 #include <wing/MessageBox.hpp>
-#include <sngxml/dom/Parser.hpp>
+#include <sngxml/dom/DocumentCache.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/Unicode.hpp>
 #include <boost/filesystem.hpp>
@@ -715,7 +715,8 @@ void MainWindow::OpenPackageClick()
                 return;
             }
             std::string packageXMLFilePath = GetFullPath(filePath);
-            std::unique_ptr<sngxml::dom::Document> packageDoc(sngxml::dom::ReadDocument(packageXMLFilePath));
+            std::shared_ptr<sngxml::dom::Document> packageDoc = sngxml::dom::ReadCachedDocument(packageXMLFilePath,
+                sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena | sngxml::dom::Flags::utf8);
             package.reset(new Package(packageXMLFilePath, packageDoc->DocumentElement()));
             packageFilePathStatusBarItem->SetText(packageXMLFilePath);
             ShowPackageFilePathStatusItems();
@@ -762,13 +762,13 @@ bool Rule::Matches(const std::u32string& name)
         Package* package = GetPackage();
         if (package)
         {
-            nfa = soulng::rex::CompileFilePattern(package->GetContext(), ToUtf32(Value()));
+            matcher = package->GetContext().GetFilePatternMatcher(ToUtf32(Value()));
             compiled = true;
         }
     }
     if (compiled)
     {
-        return soulng::rex::PatternMatch(name, nfa);
+        return matcher->Match(ToUtf8(name));
     }
     return false;
 }
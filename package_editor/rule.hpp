@@ -7,7 +7,7 @@
 #define WINGSTALL_PACKAGE_EDITOR_RULE_INCLUDED
 #include <package_editor/node.hpp>
 #include <sngxml/dom/Element.hpp>
-#include <soulng/rex/Nfa.hpp>
+#include <soulng/rex/FilePattern.hpp>
 #include <wing/TreeView.hpp>
 
 namespace wingstall { namespace package_editor {
@@ -102,7 +102,7 @@ private:
     std::vector<std::unique_ptr<Rule>> rules;
     std::string value;
     bool compiled;
-    soulng::rex::Nfa nfa;
+    std::shared_ptr<const soulng::rex::FilePatternMatcher> matcher;
 };
 
 Rule* MakeExcludeDebugDirRule();
@@ -0,0 +1,337 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/api.hpp>
+#include <wingpackage/path_matcher.hpp>
+#include <soulng/rex/Context.hpp>
+#include <soulng/rex/Match.hpp>
+#include <soulng/util/InitDone.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+using namespace wingstall::wingpackage;
+using namespace soulng::unicode;
+
+void InitApplication()
+{
+    soulng::util::Init();
+}
+
+struct Results
+{
+    Results() : checks(0), failures(0) {}
+    int checks;
+    int failures;
+};
+
+void Check(Results& results, bool condition, const std::string& description)
+{
+    ++results.checks;
+    if (!condition)
+    {
+        ++results.failures;
+        std::cout << "FAILED: " << description << std::endl;
+    }
+}
+
+std::string KindStr(PathKind pathKind)
+{
+    return pathKind == PathKind::dir ? "dir" : "file";
+}
+
+// A chain of rule sets in which each set is the parent of the next one. The rules of each set are kept, so that the verdicts of the rule loop
+// PathRuleSet used before its rules were compiled into a matcher can be computed for comparison. The loop matches names with an NFA compiled from each pattern.
+
+class RuleSetChain
+{
+public:
+    RuleSetChain(PathMatcher& pathMatcher_);
+    void BeginSet();
+    void AddRule(const std::string& pattern, RuleKind ruleKind, PathKind pathKind);
+    void EndSet();
+    bool Include(int level, const std::string& name, PathKind pathKind) const;
+    bool ExpectedInclude(int level, const std::string& name, PathKind pathKind);
+private:
+    bool Matches(const std::string& pattern, const std::string& name);
+    PathMatcher& pathMatcher;
+    soulng::rex::Context context;
+    std::map<std::string, soulng::rex::Nfa> nfas;
+    std::vector<std::shared_ptr<PathRuleSet>> sets;
+    std::vector<std::vector<PathRule*>> levels;
+};
+
+RuleSetChain::RuleSetChain(PathMatcher& pathMatcher_) : pathMatcher(pathMatcher_)
+{
+}
+
+void RuleSetChain::BeginSet()
+{
+    std::shared_ptr<PathRuleSet> parent;
+    if (!sets.empty())
+    {
+        parent = sets.back();
+    }
+    sets.push_back(std::shared_ptr<PathRuleSet>(new PathRuleSet(parent)));
+    levels.push_back(std::vector<PathRule*>());
+}
+
+void RuleSetChain::AddRule(const std::string& pattern, RuleKind ruleKind, PathKind pathKind)
+{
+    PathRule* rule = new PathRule(pathMatcher, pattern, ruleKind, pathKind);
+    sets.back()->AddRule(rule);
+    levels.back().push_back(rule);
+}
+
+void RuleSetChain::EndSet()
+{
+    sets.back()->Compile();
+}
+
+bool RuleSetChain::Include(int level, const std::string& name, PathKind pathKind) const
+{
+    if (pathKind == PathKind::dir)
+    {
+        return sets[level]->IncludeDir(name);
+    }
+    else
+    {
+        return sets[level]->IncludeFile(name);
+    }
+}
+
+// The last matching rule of the set itself decides. If none of them matches, the cascading rules of the parent sets are tried nearest parent first,
+// and the last matching rule of the first parent that has one decides. A name no rule matches is included.
+
+bool RuleSetChain::ExpectedInclude(int level, const std::string& name, PathKind pathKind)
+{
+    for (int i = level; i >= 0; --i)
+    {
+        bool include = true;
+        bool matched = false;
+        for (PathRule* rule : levels[i])
+        {
+            if (rule->GetPathKind() != pathKind) continue;
+            if (i < level && (rule->GetRuleKind() & RuleKind::cascade) == RuleKind::none) continue;
+            if (Matches(rule->Name(), name))
+            {
+                include = (rule->GetRuleKind() & RuleKind::include) != RuleKind::none;
+                matched = true;
+            }
+        }
+        if (matched)
+        {
+            return include;
+        }
+    }
+    return true;
+}
+
+bool RuleSetChain::Matches(const std::string& pattern, const std::string& name)
+{
+    auto it = nfas.find(pattern);
+    if (it == nfas.cend())
+    {
+        it = nfas.insert(std::make_pair(pattern, soulng::rex::CompileFilePattern(context, ToUtf32(pattern)))).first;
+    }
+    return soulng::rex::PatternMatch(ToUtf32(name), it->second);
+}
+
+// Checks both the compiled matcher and the rule loop against the verdict expected by the test.
+
+void CheckName(Results& results, RuleSetChain& chain, int level, const std::string& name, PathKind pathKind, bool expected, const std::string& test)
+{
+    std::string description = test + ": " + KindStr(pathKind) + " '" + name + "' at level " + std::to_string(level) + " should be " + (expected ? "included" : "excluded");
+    Check(results, chain.Include(level, name, pathKind) == expected, description + " (compiled matcher)");
+    Check(results, chain.ExpectedInclude(level, name, pathKind) == expected, description + " (rule loop)");
+}
+
+void TestNoMatchIncludes(Results& results, PathMatcher& pathMatcher)
+{
+    RuleSetChain chain(pathMatcher);
+    chain.BeginSet();
+    chain.EndSet();
+    CheckName(results, chain, 0, "main.cpp", PathKind::file, true, "empty rule set");
+    CheckName(results, chain, 0, "src", PathKind::dir, true, "empty rule set");
+    chain.BeginSet();
+    chain.AddRule("*.obj", RuleKind::exclude, PathKind::file);
+    chain.AddRule("x64", RuleKind::exclude, PathKind::dir);
+    chain.EndSet();
+    CheckName(results, chain, 1, "main.cpp", PathKind::file, true, "no match");
+    CheckName(results, chain, 1, "main.obj", PathKind::file, false, "no match");
+    CheckName(results, chain, 1, "src", PathKind::dir, true, "no match");
+    CheckName(results, chain, 1, "x64", PathKind::dir, false, "no match");
+}
+
+void TestLastMatchWins(Results& results, PathMatcher& pathMatcher)
+{
+    RuleSetChain chain(pathMatcher);
+    chain.BeginSet();
+    chain.AddRule("*.cpp", RuleKind::exclude, PathKind::file);
+    chain.AddRule("main.cpp", RuleKind::include, PathKind::file);
+    chain.AddRule("main.cpp", RuleKind::exclude, PathKind::dir);
+    chain.EndSet();
+    CheckName(results, chain, 0, "main.cpp", PathKind::file, true, "last match wins");
+    CheckName(results, chain, 0, "other.cpp", PathKind::file, false, "last match wins");
+    CheckName(results, chain, 0, "main.cpp", PathKind::dir, false, "last match wins");
+    RuleSetChain reversed(pathMatcher);
+    reversed.BeginSet();
+    reversed.AddRule("main.cpp", RuleKind::include, PathKind::file);
+    reversed.AddRule("*.cpp", RuleKind::exclude, PathKind::file);
+    reversed.EndSet();
+    CheckName(results, reversed, 0, "main.cpp", PathKind::file, false, "last match wins, reversed");
+}
+
+void TestCascadePrecedence(Results& results, PathMatcher& pathMatcher)
+{
+    RuleSetChain chain(pathMatcher);
+    chain.BeginSet();
+    chain.AddRule("*.txt", RuleKind::exclude | RuleKind::cascade, PathKind::file);
+    chain.AddRule("*.cfg", RuleKind::include | RuleKind::cascade, PathKind::file);
+    chain.AddRule("*.ini", RuleKind::exclude, PathKind::file);
+    chain.AddRule("obj", RuleKind::exclude | RuleKind::cascade, PathKind::dir);
+    chain.EndSet();
+    chain.BeginSet();
+    chain.AddRule("read*.txt", RuleKind::include | RuleKind::cascade, PathKind::file);
+    chain.AddRule("*.cfg", RuleKind::exclude, PathKind::file);
+    chain.AddRule("obj", RuleKind::include, PathKind::dir);
+    chain.EndSet();
+    chain.BeginSet();
+    chain.AddRule("notes.txt", RuleKind::include, PathKind::file);
+    chain.AddRule("readonly.txt", RuleKind::exclude, PathKind::file);
+    chain.EndSet();
+    CheckName(results, chain, 2, "notes.txt", PathKind::file, true, "own rule before cascading rules");
+    CheckName(results, chain, 2, "readonly.txt", PathKind::file, false, "own rule before cascading rules");
+    CheckName(results, chain, 2, "readme.txt", PathKind::file, true, "nearest parent decides");
+    CheckName(results, chain, 2, "other.txt", PathKind::file, false, "distant parent decides when nearer parents do not match");
+    CheckName(results, chain, 2, "app.cfg", PathKind::file, true, "rules that do not cascade apply only to their own set");
+    CheckName(results, chain, 2, "app.ini", PathKind::file, true, "rules that do not cascade apply only to their own set");
+    CheckName(results, chain, 1, "app.cfg", PathKind::file, false, "own rule before cascading rules");
+    CheckName(results, chain, 1, "app.ini", PathKind::file, true, "rules that do not cascade apply only to their own set");
+    CheckName(results, chain, 0, "app.ini", PathKind::file, false, "own rules");
+    CheckName(results, chain, 1, "obj", PathKind::dir, true, "own rule before cascading rules");
+    CheckName(results, chain, 2, "obj", PathKind::dir, false, "rules that do not cascade apply only to their own set");
+}
+
+// The rules of one set cover every kind of pattern: any, suffix, prefix, infix, exact and patterns that need an automaton.
+
+void TestMixedRuleKinds(Results& results, PathMatcher& pathMatcher)
+{
+    RuleSetChain chain(pathMatcher);
+    chain.BeginSet();
+    chain.AddRule("*", RuleKind::exclude, PathKind::file);
+    chain.AddRule("*.cpp", RuleKind::include, PathKind::file);
+    chain.AddRule("test*", RuleKind::exclude, PathKind::file);
+    chain.AddRule("*main*", RuleKind::include, PathKind::file);
+    chain.AddRule("main.cpp", RuleKind::exclude, PathKind::file);
+    chain.AddRule("a?c.*", RuleKind::include, PathKind::file);
+    chain.AddRule("*.t?r", RuleKind::exclude, PathKind::file);
+    chain.EndSet();
+    CheckName(results, chain, 0, "readme", PathKind::file, false, "mixed rules");
+    CheckName(results, chain, 0, "x.cpp", PathKind::file, true, "mixed rules");
+    CheckName(results, chain, 0, "test.cpp", PathKind::file, false, "mixed rules");
+    CheckName(results, chain, 0, "testmain.cpp", PathKind::file, true, "mixed rules");
+    CheckName(results, chain, 0, "main.cpp", PathKind::file, false, "mixed rules");
+    CheckName(results, chain, 0, "mainx", PathKind::file, true, "mixed rules");
+    CheckName(results, chain, 0, "abc.cpp", PathKind::file, true, "mixed rules");
+    CheckName(results, chain, 0, "abc.txt", PathKind::file, true, "mixed rules");
+    CheckName(results, chain, 0, "abc.tar", PathKind::file, false, "mixed rules");
+    CheckName(results, chain, 0, "test.tar", PathKind::file, false, "mixed rules");
+    CheckName(results, chain, 0, "", PathKind::file, false, "mixed rules");
+    RuleSetChain later(pathMatcher);
+    later.BeginSet();
+    later.AddRule("keep.cpp", RuleKind::exclude, PathKind::file);
+    later.AddRule("*.cpp", RuleKind::include, PathKind::file);
+    later.AddRule("k?ep.*", RuleKind::exclude, PathKind::file);
+    later.AddRule("keep*", RuleKind::include, PathKind::file);
+    later.AddRule("*.log", RuleKind::include, PathKind::file);
+    later.AddRule("?.log", RuleKind::exclude, PathKind::file);
+    later.EndSet();
+    CheckName(results, later, 0, "keep.cpp", PathKind::file, true, "later literal rule after exact and automaton rules");
+    CheckName(results, later, 0, "kxep.cpp", PathKind::file, false, "later automaton rule after literal rule");
+    CheckName(results, later, 0, "keep.txt", PathKind::file, true, "later literal rule after automaton rule");
+    CheckName(results, later, 0, "a.log", PathKind::file, false, "later automaton rule after literal rule");
+    CheckName(results, later, 0, "ab.log", PathKind::file, true, "later automaton rule after literal rule");
+}
+
+// Compares the compiled matcher with the rule loop on random chains of rule sets. The random number generator has a fixed seed, so each run checks the same cases.
+
+void TestRandomChains(Results& results, PathMatcher& pathMatcher)
+{
+    std::vector<std::string> patterns = { "*", "*.obj", "*.cpp", "lib*", "x.h", ".git", "a?c", "*.t?r", "*o*", "?", "bin", "*.h", "[bx]in", "*.(cpp|hpp)", "**" };
+    std::vector<std::string> names = { "a.obj", "b.cpp", "libx", "x.h", ".git", "abc", "a.tar", "foo", "b", "bin", "xin", "x.hpp", "q.h", "", "lib.cpp", "azc" };
+    std::mt19937 rng(33);
+    int mismatches = 0;
+    for (int i = 0; i < 3000; ++i)
+    {
+        RuleSetChain chain(pathMatcher);
+        int depth = 1 + rng() % 4;
+        for (int level = 0; level < depth; ++level)
+        {
+            chain.BeginSet();
+            int ruleCount = rng() % 7;
+            for (int k = 0; k < ruleCount; ++k)
+            {
+                RuleKind ruleKind = rng() % 2 == 0 ? RuleKind::include : RuleKind::exclude;
+                if (rng() % 2 == 0)
+                {
+                    ruleKind = ruleKind | RuleKind::cascade;
+                }
+                PathKind pathKind = rng() % 2 == 0 ? PathKind::dir : PathKind::file;
+                chain.AddRule(patterns[rng() % patterns.size()], ruleKind, pathKind);
+            }
+            chain.EndSet();
+        }
+        for (int level = 0; level < depth; ++level)
+        {
+            for (const std::string& name : names)
+            {
+                for (PathKind pathKind : { PathKind::dir, PathKind::file })
+                {
+                    bool expected = chain.ExpectedInclude(level, name, pathKind);
+                    bool include = chain.Include(level, name, pathKind);
+                    ++results.checks;
+                    if (include != expected)
+                    {
+                        ++results.failures;
+                        if (++mismatches <= 10)
+                        {
+                            std::cout << "FAILED: random chain " << i << ": " << KindStr(pathKind) << " '" << name << "' at level " << level << ": compiled matcher " <<
+                                (include ? "includes" : "excludes") << ", rule loop " << (expected ? "includes" : "excludes") << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    try
+    {
+        InitApplication();
+        PathMatcher pathMatcher("path_matcher_test.package.xml");
+        Results results;
+        TestNoMatchIncludes(results, pathMatcher);
+        TestLastMatchWins(results, pathMatcher);
+        TestCascadePrecedence(results, pathMatcher);
+        TestMixedRuleKinds(results, pathMatcher);
+        TestRandomChains(results, pathMatcher);
+        std::cout << results.checks << " checks, " << results.failures << " failures" << std::endl;
+        if (results.failures != 0)
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <soulng/rex/Context.hpp>
+#include <soulng/rex/Dfa.hpp>
+#include <soulng/rex/FilePattern.hpp>
+#include <soulng/rex/Match.hpp>
+#include <soulng/util/InitDone.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace soulng::rex;
+using namespace soulng::unicode;
+
+void InitApplication()
+{
+    soulng::util::Init();
+}
+
+const char* stems[] = { "main", "lexer", "parser", "file_pattern", "path_matcher", "some_source_file_name", "Makefile", "libz", "test", "readme" };
+const char* suffixes[] = { "", "_test", "_impl", "2", "-old", "tr" };
+const char* extensions[] = { ".cpp", ".hpp", ".h", ".txt", ".tar.gz", ".so.1", ".vcxproj", ".xml", "", "~" };
+
+// Makes file names from a stem, a suffix and an extension, like the names in a source tree.
+
+std::vector<std::string> MakeNames(int numNames)
+{
+    std::mt19937 random(31);
+    std::vector<std::string> names;
+    for (int i = 0; i < numNames; ++i)
+    {
+        std::string name = stems[random() % (sizeof(stems) / sizeof(stems[0]))];
+        name.append(suffixes[random() % (sizeof(suffixes) / sizeof(suffixes[0]))]);
+        name.append(extensions[random() % (sizeof(extensions) / sizeof(extensions[0]))]);
+        names.push_back(name);
+    }
+    return names;
+}
+
+// Literal patterns are matched without an automaton by FilePatternMatcher. The others are matched with the DFA.
+
+const char* patterns[] = { "*.cpp", "*_test.?pp", "*.t*r.*", "?akefile", "li*.so.*", "*a*e*r*", "*~" };
+
+struct Timing
+{
+    Timing() : seconds(0), matches(0) {}
+    double seconds;
+    int matches;
+};
+
+template<typename MatchFn>
+Timing TimeMatches(const std::vector<std::string>& names, MatchFn match)
+{
+    Timing timing;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& name : names)
+    {
+        if (match(name))
+        {
+            ++timing.matches;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    timing.seconds = std::chrono::duration<double>(end - start).count();
+    return timing;
+}
+
+std::string NamesPerSecond(const Timing& timing, int numNames)
+{
+    std::stringstream s;
+    s << std::fixed << std::setprecision(2) << std::setw(9) << numNames / timing.seconds / 1e6 << " M names/s";
+    return s.str();
+}
+
+// Matches generated file names against each pattern by simulating the NFA, by walking the DFA, and with the FilePatternMatcher that PathRule uses.
+// Checks that all three give the same result for each name, and prints names per second. The number of names is 100000 by default.
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        InitApplication();
+        int numNames = 100000;
+        if (argc > 1)
+        {
+            numNames = std::stoi(argv[1]);
+        }
+        std::vector<std::string> names = MakeNames(numNames);
+        std::vector<std::u32string> utf32Names;
+        for (const std::string& name : names)
+        {
+            utf32Names.push_back(ToUtf32(name));
+        }
+        for (const char* pattern : patterns)
+        {
+            std::u32string filePattern = ToUtf32(std::string(pattern));
+            Context context;
+            Nfa nfa = CompileFilePattern(context, filePattern);
+            Dfa dfa = MakeDfa(nfa);
+            FilePatternMatcher matcher(context, filePattern);
+            for (int i = 0; i < numNames; ++i)
+            {
+                bool nfaMatch = PatternMatch(utf32Names[i], nfa);
+                if (dfa.MatchUtf8(names[i]) != nfaMatch || matcher.Match(names[i]) != nfaMatch)
+                {
+                    throw std::runtime_error("pattern '" + std::string(pattern) + "' matches name '" + names[i] + "' differently with the NFA, the DFA and the file pattern matcher");
+                }
+            }
+            int index = 0;
+            Timing nfaTiming = TimeMatches(names, [&](const std::string&) { return PatternMatch(utf32Names[index++], nfa); });
+            Timing dfaTiming = TimeMatches(names, [&](const std::string& name) { return dfa.MatchUtf8(name); });
+            Timing matcherTiming = TimeMatches(names, [&](const std::string& name) { return matcher.Match(name); });
+            std::cout << pattern << ": " << dfaTiming.matches << " of " << numNames << " names match, DFA has " << dfa.StateCount() << " states" << std::endl;
+            std::cout << "  NFA:     " << NamesPerSecond(nfaTiming, numNames) << std::endl;
+            std::cout << "  DFA:     " << NamesPerSecond(dfaTiming, numNames) << std::endl;
+            std::cout << "  matcher: " << NamesPerSecond(matcherTiming, numNames) << std::endl;
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -33,6 +33,10 @@ CharacterData::CharacterData(NodeType nodeType_, const std::u32string& name_, co
 {
 }
 
+CharacterData::CharacterData(NodeType nodeType_, const std::u32string* internedName_, const std::u32string& data_) : Node(nodeType_, internedName_), data(data_)
+{
+}
+
 void CharacterData::Write(CodeFormatter& formatter)
 {
     formatter.Write(ToUtf8(XmlCharDataEscape(data)));
@@ -43,11 +47,19 @@ bool CharacterData::ValueContainsNewLine() const
     return data.find('\n') != std::u32string::npos;
 }
 
-Text::Text() : CharacterData(NodeType::textNode, U"text")
+// All text nodes share one copy of their name.
+
+const std::u32string& TextNodeName()
+{
+    static const std::u32string textNodeName = U"text";
+    return textNodeName;
+}
+
+Text::Text() : CharacterData(NodeType::textNode, &TextNodeName(), std::u32string())
 {
 }
 
-Text::Text(const std::u32string& data_) : CharacterData(NodeType::textNode, U"text", data_)
+Text::Text(const std::u32string& data_) : CharacterData(NodeType::textNode, &TextNodeName(), data_)
 {
 }
 
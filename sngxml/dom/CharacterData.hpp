@@ -16,6 +16,7 @@ class SNGXML_DOM_API CharacterData : public Node
 public:
     CharacterData(NodeType nodeType_, const std::u32string& name_);
     CharacterData(NodeType nodeType_, const std::u32string& name_, const std::u32string& data_);
+    CharacterData(NodeType nodeType_, const std::u32string* internedName_, const std::u32string& data_);
     CharacterData(const CharacterData&) = delete;
     CharacterData& operator=(const CharacterData&) = delete;
     CharacterData(CharacterData&&) = delete;
@@ -5,6 +5,7 @@
 
 #include <sngxml/dom/Document.hpp>
 #include <sngxml/dom/Element.hpp>
+#include <sngxml/dom/CharacterData.hpp>
 #include <sngxml/dom/Exception.hpp>
 #include <soulng/util/Unicode.hpp>
 #include <soulng/util/Error.hpp>
@@ -13,10 +14,25 @@ namespace sngxml { namespace dom {
 
 using namespace soulng::unicode;
 
-Document::Document() : ParentNode(NodeType::documentNode, U"document"), documentElement(nullptr), indexValid(false), xmlStandalone(false)
+Document::Document() : Document(false)
 {
 }
 
+Document::Document(bool useArena) : ParentNode(NodeType::documentNode, U"document"), documentElement(nullptr), indexValid(false), xmlStandalone(false)
+{
+    if (useArena)
+    {
+        arena.reset(new NodeArena());
+    }
+}
+
+// The children are deleted here, before the arena they may have been allocated from.
+
+Document::~Document()
+{
+    DeleteChildren();
+}
+
 void Document::Write(CodeFormatter& formatter)
 {
     if (!xmlVersion.empty() && !xmlEncoding.empty())
@@ -151,6 +167,31 @@ Element* Document::GetElementById(const std::u32string& elementId)
     return nullptr;
 }
 
+// Nodes created by a document that uses an arena are allocated from the arena and their names are interned.
+
+std::unique_ptr<Element> Document::CreateElement(const std::u32string& name)
+{
+    if (arena)
+    {
+        return std::unique_ptr<Element>(new (arena.get()) Element(arena->Intern(name)));
+    }
+    return std::unique_ptr<Element>(new Element(name));
+}
+
+std::unique_ptr<Attr> Document::CreateAttribute(const std::u32string& name, const std::u32string& value)
+{
+    if (arena)
+    {
+        return std::unique_ptr<Attr>(new (arena.get()) Attr(arena->Intern(name), value));
+    }
+    return std::unique_ptr<Attr>(new Attr(name, value));
+}
+
+std::unique_ptr<Text> Document::CreateTextNode(const std::u32string& data)
+{
+    return std::unique_ptr<Text>(new (arena.get()) Text(data));
+}
+
 void Document::CheckValidInsert(Node* node, Node* refNode)
 {
     if (node->GetNodeType() == NodeType::elementNode)
@@ -6,16 +6,20 @@
 #ifndef SNGXML_DOM_DOCUMENT_INCLUDED
 #define SNGXML_DOM_DOCUMENT_INCLUDED
 #include <sngxml/dom/Node.hpp>
+#include <sngxml/dom/NodeArena.hpp>
 #include <unordered_map>
 
 namespace sngxml { namespace dom {
 
 class Element;
+class Attr;
 
 class SNGXML_DOM_API Document : public ParentNode
 {
 public:
     Document();
+    Document(bool useArena);
+    ~Document() override;
     Document(const Document&) = delete;
     Document& operator=(const Document&) = delete;
     Document(Document&&) = delete;
@@ -36,7 +40,12 @@ public:
     const std::u32string& XmlEncoding() const { return xmlEncoding; }
     void Accept(Visitor& visitor) override;
     void InternalInvalidateIndex();
+    NodeArena* Arena() const { return arena.get(); }
+    std::unique_ptr<Element> CreateElement(const std::u32string& name);
+    std::unique_ptr<Attr> CreateAttribute(const std::u32string& name, const std::u32string& value);
+    std::unique_ptr<Text> CreateTextNode(const std::u32string& data);
 private:
+    std::unique_ptr<NodeArena> arena;
     Element* documentElement;
     void CheckValidInsert(Node* node, Node* refNode);
     std::unordered_map<std::u32string, Element*> elementsByIdMap;
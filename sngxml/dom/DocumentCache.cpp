@@ -0,0 +1,177 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/dom/DocumentCache.hpp>
+#include <soulng/util/Path.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace sngxml { namespace dom {
+
+using namespace soulng::util;
+
+const int defaultDocumentCacheCapacity = 16;
+
+FileStamp::FileStamp() : time(), size(0), readTime()
+{
+}
+
+// The clock is read before the file, so a write that happens after the stamp is taken always gets a time that is not before readTime.
+// An invalid stamp is returned for a file that does not exist or cannot be accessed.
+
+FileStamp GetFileStamp(const std::string& filePath)
+{
+    FileStamp stamp;
+    stamp.readTime = std::time(nullptr);
+    boost::system::error_code ec;
+    boost::filesystem::path path = MakeNativeBoostPath(filePath);
+    std::time_t time = boost::filesystem::last_write_time(path, ec);
+    if (ec)
+    {
+        return FileStamp();
+    }
+    uintmax_t size = boost::filesystem::file_size(path, ec);
+    if (ec)
+    {
+        return FileStamp();
+    }
+    stamp.time = time;
+    stamp.size = size;
+    return stamp;
+}
+
+bool IsUnchanged(const FileStamp& cached, const FileStamp& current)
+{
+    return cached.IsValid() && current.IsValid() && cached.time == current.time && cached.size == current.size && cached.time < cached.readTime;
+}
+
+struct CachedDocument
+{
+    CachedDocument(const std::string& key_, const FileStamp& stamp_, const std::shared_ptr<Document>& document_);
+    std::string key;
+    FileStamp stamp;
+    std::shared_ptr<Document> document;
+};
+
+CachedDocument::CachedDocument(const std::string& key_, const FileStamp& stamp_, const std::shared_ptr<Document>& document_) : key(key_), stamp(stamp_), document(document_)
+{
+}
+
+class DocumentCache
+{
+public:
+    static DocumentCache& Instance();
+    std::shared_ptr<Document> Get(const std::string& fileName, Flags flags);
+    void SetCapacity(int capacity_);
+    int Capacity();
+    void Clear();
+private:
+    DocumentCache();
+    void Trim();
+    std::mutex mtx;
+    int capacity;
+    std::list<CachedDocument> lru;
+    std::unordered_map<std::string, std::list<CachedDocument>::iterator> map;
+};
+
+DocumentCache::DocumentCache() : capacity(defaultDocumentCacheCapacity)
+{
+}
+
+DocumentCache& DocumentCache::Instance()
+{
+    static DocumentCache instance;
+    return instance;
+}
+
+// The file is parsed without holding the lock, so a slow or failing parse does not block the other threads.
+// The stamp is taken before the file is parsed: if the file changes while it is being parsed, the stamp does not match the next time.
+
+std::shared_ptr<Document> DocumentCache::Get(const std::string& fileName, Flags flags)
+{
+    std::string key = std::to_string(static_cast<int>(flags)) + ":" + GetFullPath(fileName);
+    FileStamp stamp = GetFileStamp(fileName);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = map.find(key);
+        if (it != map.cend())
+        {
+            if (IsUnchanged(it->second->stamp, stamp))
+            {
+                lru.splice(lru.begin(), lru, it->second);
+                return it->second->document;
+            }
+            lru.erase(it->second);
+            map.erase(it);
+        }
+    }
+    std::shared_ptr<Document> document = ReadDocument(fileName, flags);
+    if (!stamp.IsValid()) return document;
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = map.find(key);
+    if (it != map.cend())
+    {
+        lru.erase(it->second);
+        map.erase(it);
+    }
+    lru.push_front(CachedDocument(key, stamp, document));
+    map[key] = lru.begin();
+    Trim();
+    return document;
+}
+
+void DocumentCache::SetCapacity(int capacity_)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    capacity = std::max(0, capacity_);
+    Trim();
+}
+
+int DocumentCache::Capacity()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return capacity;
+}
+
+void DocumentCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    map.clear();
+    lru.clear();
+}
+
+void DocumentCache::Trim()
+{
+    while (static_cast<int>(lru.size()) > capacity)
+    {
+        map.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+std::shared_ptr<Document> ReadCachedDocument(const std::string& fileName, Flags flags)
+{
+    return DocumentCache::Instance().Get(fileName, flags);
+}
+
+void SetDocumentCacheCapacity(int capacity)
+{
+    DocumentCache::Instance().SetCapacity(capacity);
+}
+
+int DocumentCacheCapacity()
+{
+    return DocumentCache::Instance().Capacity();
+}
+
+void ClearDocumentCache()
+{
+    DocumentCache::Instance().Clear();
+}
+
+} } // namespace sngxml::dom
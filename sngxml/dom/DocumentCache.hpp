@@ -0,0 +1,48 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_DOM_DOCUMENT_CACHE_INCLUDED
+#define SNGXML_DOM_DOCUMENT_CACHE_INCLUDED
+#include <sngxml/dom/Parser.hpp>
+#include <ctime>
+
+namespace sngxml { namespace dom {
+
+//  ===================================================================================
+//  The last write time and size of a file when it was read. A cached result derived
+//  from the file is still valid if the file has the same stamp now. Write times have
+//  a resolution of one second, so a file that was written during the second it was
+//  read may have been changed again without changing its stamp: such a stamp never
+//  matches, and the file is read again.
+//  ===================================================================================
+
+struct SNGXML_DOM_API FileStamp
+{
+    FileStamp();
+    bool IsValid() const { return time != std::time_t(); }
+    std::time_t time;
+    uint64_t size;
+    std::time_t readTime;
+};
+
+SNGXML_DOM_API FileStamp GetFileStamp(const std::string& filePath);
+SNGXML_DOM_API bool IsUnchanged(const FileStamp& cached, const FileStamp& current);
+
+//  ===================================================================================
+//  ReadCachedDocument parses an XML file once and returns the same document for as
+//  long as the file stays unchanged. Documents are keyed by full path and flags, and
+//  the least recently used ones are dropped when there are more than the capacity.
+//  The returned document is shared with other readers of the same file, so it must
+//  not be modified.
+//  ===================================================================================
+
+SNGXML_DOM_API std::shared_ptr<Document> ReadCachedDocument(const std::string& fileName, Flags flags);
+SNGXML_DOM_API void SetDocumentCacheCapacity(int capacity);
+SNGXML_DOM_API int DocumentCacheCapacity();
+SNGXML_DOM_API void ClearDocumentCache();
+
+} } // namespace sngxml::dom
+
+#endif // SNGXML_DOM_DOCUMENT_CACHE_INCLUDED
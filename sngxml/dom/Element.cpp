@@ -4,7 +4,10 @@
 // =================================
 
 #include <sngxml/dom/Element.hpp>
+#include <sngxml/dom/Document.hpp>
 #include <soulng/util/Unicode.hpp>
+#include <algorithm>
+#include <mutex>
 
 namespace sngxml { namespace dom {
 
@@ -51,30 +54,144 @@ std::u32string MakeXmlAttrValue(const std::u32string& attributeValue)
     return result;
 }
 
-Attr::Attr() : Node(NodeType::attributeNode, U""), value(U"")
+// UTF-8 encodes characters other than ASCII with bytes 0x80 and above, so the UTF-8 value can be escaped byte by byte.
+
+std::string AttrValueEscape(std::string_view attributeValue, char delimiter)
+{
+    std::string result;
+    result.reserve(attributeValue.length());
+    for (char c : attributeValue)
+    {
+        switch (c)
+        {
+        case '<': result.append("&lt;"); break;
+        case '&': result.append("&amp;"); break;
+        case '"': if (delimiter == '"') result.append("&quot;"); else result.append(1, '"'); break;
+        case '\'': if (delimiter == '\'') result.append("&apos;"); else result.append(1, '\''); break;
+        default: result.append(1, c); break;
+        }
+    }
+    return result;
+}
+
+std::string MakeXmlAttrValue(std::string_view attributeValue)
+{
+    char delimiter = '"';
+    if (attributeValue.find('"') != std::string_view::npos && attributeValue.find('\'') == std::string_view::npos)
+    {
+        delimiter = '\'';
+    }
+    std::string result(1, delimiter);
+    result.append(AttrValueEscape(attributeValue, delimiter));
+    result.append(1, delimiter);
+    return result;
+}
+
+const int utf32Form = 1 << 0;
+const int utf8Form = 1 << 1;
+
+std::mutex attrValueConversionMutex;
+
+Attr::Attr() : Node(NodeType::attributeNode, U""), value(U""), forms(utf32Form)
+{
+}
+
+Attr::Attr(const std::u32string& name_, const std::u32string& value_) : Node(NodeType::attributeNode, name_), value(value_), forms(utf32Form)
 {
 }
 
-Attr::Attr(const std::u32string& name_, const std::u32string& value_) : Node(NodeType::attributeNode, name_), value(value_)
+Attr::Attr(const std::u32string* internedName_, const std::u32string& value_) : Node(NodeType::attributeNode, internedName_), value(value_), forms(utf32Form)
 {
 }
 
 std::unique_ptr<Node> Attr::CloneNode(bool deep)
 {
-    return std::unique_ptr<Node>(new Attr(Name(), value));
+    std::unique_ptr<Attr> clone(new Attr(Name(), std::u32string()));
+    if (HasUtf8Value())
+    {
+        clone->SetUtf8Value(utf8Value);
+    }
+    else
+    {
+        clone->value = value;
+    }
+    return std::unique_ptr<Node>(clone.release());
 }
 
 void Attr::Write(CodeFormatter& formatter)
 {
     formatter.Write(" " + ToUtf8(Name()) + "=");
-    formatter.Write(ToUtf8(MakeXmlAttrValue(value)));
+    if (HasUtf8Value())
+    {
+        formatter.Write(MakeXmlAttrValue(std::string_view(utf8Value)));
+    }
+    else
+    {
+        formatter.Write(ToUtf8(MakeXmlAttrValue(value)));
+    }
+}
+
+const std::u32string& Attr::Value() const
+{
+    if ((forms.load(std::memory_order_acquire) & utf32Form) == 0)
+    {
+        std::lock_guard<std::mutex> lock(attrValueConversionMutex);
+        if ((forms.load(std::memory_order_relaxed) & utf32Form) == 0)
+        {
+            value = ToUtf32(utf8Value);
+            forms.fetch_or(utf32Form, std::memory_order_release);
+        }
+    }
+    return value;
+}
+
+void Attr::SetValue(const std::u32string& value_)
+{
+    value = value_;
+    utf8Value.clear();
+    forms.store(utf32Form);
+}
+
+std::string_view Attr::Utf8Value() const
+{
+    if ((forms.load(std::memory_order_acquire) & utf8Form) == 0)
+    {
+        std::lock_guard<std::mutex> lock(attrValueConversionMutex);
+        if ((forms.load(std::memory_order_relaxed) & utf8Form) == 0)
+        {
+            utf8Value = ToUtf8(value);
+            forms.fetch_or(utf8Form, std::memory_order_release);
+        }
+    }
+    return utf8Value;
+}
+
+void Attr::SetUtf8Value(std::string_view utf8Value_)
+{
+    utf8Value = utf8Value_;
+    value.clear();
+    forms.store(utf8Form);
+}
+
+bool Attr::HasUtf8Value() const
+{
+    return (forms.load(std::memory_order_acquire) & utf8Form) != 0;
 }
 
 Element::Element(const std::u32string& name_) : ParentNode(NodeType::elementNode, name_)
 {
 }
 
-Element::Element(const std::u32string& name_, std::map<std::u32string, std::unique_ptr<Attr>>&& attributeMap_) : ParentNode(NodeType::elementNode, name_), attributeMap(std::move(attributeMap_))
+Element::Element(const std::u32string& name_, std::map<std::u32string, std::unique_ptr<Attr>>&& attributeMap_) : ParentNode(NodeType::elementNode, name_)
+{
+    attributes.reserve(attributeMap_.size());
+    for (auto& p : attributeMap_)
+    {
+        attributes.push_back(std::move(p.second));
+    }
+}
+
+Element::Element(const std::u32string* internedName_) : ParentNode(NodeType::elementNode, internedName_)
 {
 }
 
@@ -82,15 +199,14 @@ std::unique_ptr<Node> Element::CloneNode(bool deep)
 {
     std::unique_ptr<Node> clone(new Element(Name()));
     ParentNode* cloneAsParent = static_cast<ParentNode*>(clone.get());
-    std::map<std::u32string, std::unique_ptr<Attr>> clonedAttributeMap;
-    for (const auto& p : attributeMap)
+    Element* cloneAsElement = static_cast<Element*>(clone.get());
+    cloneAsElement->attributes.reserve(attributes.size());
+    for (const auto& attr : attributes)
     {
-        std::unique_ptr<Node> clonedAttrNode = p.second->CloneNode(false);
+        std::unique_ptr<Node> clonedAttrNode = attr->CloneNode(false);
         clonedAttrNode->InternalSetParent(cloneAsParent);
-        clonedAttributeMap[p.first] = std::unique_ptr<Attr>(static_cast<Attr*>(clonedAttrNode.release()));
+        cloneAsElement->attributes.push_back(std::unique_ptr<Attr>(static_cast<Attr*>(clonedAttrNode.release())));
     }
-    Element* cloneAsElement = static_cast<Element*>(clone.get());
-    cloneAsElement->attributeMap = std::move(clonedAttributeMap);
     if (deep)
     {
         CloneChildrenTo(cloneAsParent);
@@ -100,14 +216,14 @@ std::unique_ptr<Node> Element::CloneNode(bool deep)
 
 bool Element::HasAttributes() const
 {
-    return !attributeMap.empty();
+    return !attributes.empty();
 }
 
 void Element::Write(CodeFormatter& formatter)
 {
     if (HasChildNodes())
     {
-        if (attributeMap.empty())
+        if (attributes.empty())
         {
             formatter.Write("<" + ToUtf8(Name()) + ">");
         }
@@ -146,7 +262,7 @@ void Element::Write(CodeFormatter& formatter)
     }
     else
     {
-        if (attributeMap.empty())
+        if (attributes.empty())
         {
             formatter.WriteLine("<" + ToUtf8(Name()) + "/>");
         }
@@ -161,9 +277,8 @@ void Element::Write(CodeFormatter& formatter)
 
 void Element::WriteAttributes(CodeFormatter& formatter)
 {
-    for (auto& p : attributeMap)
+    for (auto& attr : attributes)
     {
-        std::unique_ptr<Attr>& attr = p.second;
         attr->Write(formatter);
     }
 }
@@ -180,37 +295,130 @@ bool Element::HasMultilineContent()
     return false;
 }
 
+// The attributes are kept in a vector sorted by name, so they are written and walked in the same order as before, when they were kept in a map.
+// Elements have only a few attributes, so a binary search in a vector is faster than a map lookup and needs no allocation per attribute.
+
+std::vector<std::unique_ptr<Attr>>::const_iterator Element::FindAttribute(const std::u32string& attrName) const
+{
+    return std::lower_bound(attributes.cbegin(), attributes.cend(), attrName, [](const std::unique_ptr<Attr>& attr, const std::u32string& name) { return attr->Name() < name; });
+}
+
+// Compares a name to a UTF-8 encoded name in code point order. Names are nearly always ASCII, so they are usually compared without a conversion.
+
+int CompareName(const std::u32string& name, std::string_view utf8Name)
+{
+    size_t n = std::min(name.length(), utf8Name.length());
+    for (size_t i = 0; i < n; ++i)
+    {
+        char32_t c = static_cast<unsigned char>(utf8Name[i]);
+        if (c >= 0x80)
+        {
+            return name.compare(ToUtf32(std::string(utf8Name)));
+        }
+        if (name[i] != c)
+        {
+            return name[i] < c ? -1 : 1;
+        }
+    }
+    if (name.length() < utf8Name.length()) return -1;
+    if (name.length() > utf8Name.length()) return 1;
+    return 0;
+}
+
+std::vector<std::unique_ptr<Attr>>::const_iterator Element::FindAttribute(std::string_view attrName) const
+{
+    return std::lower_bound(attributes.cbegin(), attributes.cend(), attrName, [](const std::unique_ptr<Attr>& attr, std::string_view name) { return CompareName(attr->Name(), name) < 0; });
+}
+
 std::u32string Element::GetAttribute(const std::u32string& attrName) const
 {
-    auto it = attributeMap.find(attrName);
-    if (it != attributeMap.cend())
+    auto it = FindAttribute(attrName);
+    if (it != attributes.cend() && (*it)->Name() == attrName)
     {
-        return it->second->Value();
+        return (*it)->Value();
     }
     return std::u32string();
 }
 
+// Returns an empty view if the element has no such attribute. The view is valid until the attribute is changed or removed.
+
+std::string_view Element::GetAttribute(std::string_view attrName) const
+{
+    auto it = FindAttribute(attrName);
+    if (it != attributes.cend() && CompareName((*it)->Name(), attrName) == 0)
+    {
+        return (*it)->Utf8Value();
+    }
+    return std::string_view();
+}
+
 void Element::AddAttribute(std::unique_ptr<Attr>&& attr)
 {
-    attributeMap[attr->Name()] = std::move(attr);
+    auto it = attributes.begin() + (FindAttribute(attr->Name()) - attributes.cbegin());
+    if (it != attributes.end() && (*it)->Name() == attr->Name())
+    {
+        *it = std::move(attr);
+    }
+    else
+    {
+        attributes.insert(it, std::move(attr));
+    }
 }
 
+// An attribute set on an element of a document is allocated from the arena of the document, if it has one.
+
 void Element::SetAttribute(const std::u32string& attrName, const std::u32string& attrValue)
 {
-    attributeMap[attrName] = std::unique_ptr<Attr>(new Attr(attrName, attrValue));
+    auto it = FindAttribute(attrName);
+    if (it != attributes.cend() && (*it)->Name() == attrName)
+    {
+        (*it)->SetValue(attrValue);
+    }
+    else if (OwnerDocument())
+    {
+        AddAttribute(OwnerDocument()->CreateAttribute(attrName, attrValue));
+    }
+    else
+    {
+        AddAttribute(std::unique_ptr<Attr>(new Attr(attrName, attrValue)));
+    }
+}
+
+void Element::SetAttribute(std::string_view attrName, std::string_view attrValue)
+{
+    auto it = FindAttribute(attrName);
+    if (it != attributes.cend() && CompareName((*it)->Name(), attrName) == 0)
+    {
+        (*it)->SetUtf8Value(attrValue);
+        return;
+    }
+    std::unique_ptr<Attr> attr;
+    if (OwnerDocument())
+    {
+        attr = OwnerDocument()->CreateAttribute(ToUtf32(std::string(attrName)), std::u32string());
+    }
+    else
+    {
+        attr.reset(new Attr(ToUtf32(std::string(attrName)), std::u32string()));
+    }
+    attr->SetUtf8Value(attrValue);
+    AddAttribute(std::move(attr));
 }
 
 void Element::RemoveAttribute(const std::u32string& attrName)
 {
-    attributeMap.erase(attrName);
+    auto it = FindAttribute(attrName);
+    if (it != attributes.cend() && (*it)->Name() == attrName)
+    {
+        attributes.erase(it);
+    }
 }
 
 void Element::WalkAttribute(NodeOp& nodeOp)
 {
-    for (const auto& p : attributeMap)
+    for (const auto& attr : attributes)
     {
-        Attr* attr = p.second.get();
-        nodeOp.Apply(attr);
+        nodeOp.Apply(attr.get());
     }
 }
 
@@ -232,7 +440,7 @@ void ElementsByTagNameVisitor::BeginVisit(Element* element)
 {
     if (element->Name() == tagName)
     {
-        elements.InternalAddNode(element);
+        elements.InternalAppendNode(element);
     }
 }
 
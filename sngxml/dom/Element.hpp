@@ -7,27 +7,38 @@
 #define SNGXML_DOM_ELEMENT_INCLUDED
 #include <sngxml/dom/Node.hpp>
 #include <soulng/lexer/SourcePos.hpp>
+#include <atomic>
 #include <map>
+#include <string_view>
 
 namespace sngxml { namespace dom {
 
 using soulng::lexer::SourcePos;
 
+// An attribute value is stored in the form it was last set in: UTF-32 or UTF-8. Reading it in the other form converts it once and keeps the converted copy.
+// The conversion is safe for concurrent readers. Setting a value while the attribute is being read from another thread is not.
+
 class SNGXML_DOM_API Attr : public Node
 {
 public:
     Attr();
     Attr(const std::u32string& name_, const std::u32string& value_);
+    Attr(const std::u32string* internedName_, const std::u32string& value_);
     Attr(const Attr&) = delete;
     Attr& operator=(const Attr&) = delete;
     Attr(Attr&&) = delete;
     Attr& operator=(Attr&&) = delete;
     std::unique_ptr<Node> CloneNode(bool deep) override;
     void Write(CodeFormatter& formatter) override;
-    const std::u32string& Value() const { return value; }
-    std::u32string& Value() { return value; }
+    const std::u32string& Value() const;
+    void SetValue(const std::u32string& value_);
+    std::string_view Utf8Value() const;
+    void SetUtf8Value(std::string_view utf8Value_);
+    bool HasUtf8Value() const;
 private:
-    std::u32string value;
+    mutable std::u32string value;
+    mutable std::string utf8Value;
+    mutable std::atomic<int> forms;
 };
 
 class SNGXML_DOM_API Element : public ParentNode
@@ -35,6 +46,7 @@ class SNGXML_DOM_API Element : public ParentNode
 public:
     Element(const std::u32string& name_);
     Element(const std::u32string& name_, std::map<std::u32string, std::unique_ptr<Attr>>&& attributeMap_);
+    Element(const std::u32string* internedName_);
     Element(const Element&) = delete;
     Element& operator=(const Element&) = delete;
     Element(Element&&) = delete;
@@ -44,17 +56,22 @@ public:
     bool HasAttributes() const override;
     void Write(CodeFormatter& formatter) override;
     std::u32string GetAttribute(const std::u32string& attrName) const;
+    std::string_view GetAttribute(std::string_view attrName) const;
     void AddAttribute(std::unique_ptr<Attr>&& attr);
     void SetAttribute(const std::u32string& attrName, const std::u32string& attrValue);
+    void SetAttribute(std::string_view attrName, std::string_view attrValue);
     void RemoveAttribute(const std::u32string& attrName);
+    void ReserveAttributes(int count) { attributes.reserve(count); }
     void WalkAttribute(NodeOp& nodeOp) override;
     NodeList GetElementsByTagName(const std::u32string& tagName);
     void Accept(Visitor& visitor) override;
     const SourcePos& GetSourcePos() const { return sourcePos; }
     void SetSourcePos(const SourcePos& sourcePos_) { sourcePos = sourcePos_; }
 private:
-    std::map<std::u32string, std::unique_ptr<Attr>> attributeMap;
+    std::vector<std::unique_ptr<Attr>> attributes;
     SourcePos sourcePos;
+    std::vector<std::unique_ptr<Attr>>::const_iterator FindAttribute(const std::u32string& attrName) const;
+    std::vector<std::unique_ptr<Attr>>::const_iterator FindAttribute(std::string_view attrName) const;
     void WriteAttributes(CodeFormatter& formatter);
     bool HasMultilineContent();
 };
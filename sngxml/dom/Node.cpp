@@ -4,10 +4,12 @@
 // =================================
 
 #include <sngxml/dom/Node.hpp>
+#include <sngxml/dom/NodeArena.hpp>
 #include <sngxml/dom/Document.hpp>
 #include <sngxml/dom/DocumentFragment.hpp>
 #include <sngxml/dom/Exception.hpp>
 #include <algorithm>
+#include <cstddef>
 
 namespace sngxml { namespace dom {
 
@@ -40,7 +42,13 @@ std::u32string AxisName(Axis axis)
     return std::u32string();
 }
 
-Node::Node(NodeType nodeType_, const std::u32string& name_) : nodeType(nodeType_), name(name_), parent(nullptr), previousSibling(nullptr), nextSibling(nullptr), ownerDocument(nullptr)
+Node::Node(NodeType nodeType_, const std::u32string& name_) :
+    nodeType(nodeType_), ownName(name_), name(&ownName), parent(nullptr), previousSibling(nullptr), nextSibling(nullptr), ownerDocument(nullptr)
+{
+}
+
+Node::Node(NodeType nodeType_, const std::u32string* internedName_) :
+    nodeType(nodeType_), ownName(), name(internedName_), parent(nullptr), previousSibling(nullptr), nextSibling(nullptr), ownerDocument(nullptr)
 {
 }
 
@@ -48,14 +56,54 @@ Node::~Node()
 {
 }
 
+// Each node is preceded by a header that tells whether it has been allocated from an arena. Deleting an arena node only runs its destructor:
+// the memory is released with the arena.
+
+const size_t nodeHeaderSize = alignof(std::max_align_t);
+
+static_assert(sizeof(NodeArena*) <= nodeHeaderSize, "node header too small");
+
+void* Node::operator new(size_t size)
+{
+    char* p = static_cast<char*>(::operator new(nodeHeaderSize + size));
+    *reinterpret_cast<NodeArena**>(p) = nullptr;
+    return p + nodeHeaderSize;
+}
+
+void* Node::operator new(size_t size, NodeArena* arena)
+{
+    if (!arena)
+    {
+        return Node::operator new(size);
+    }
+    char* p = static_cast<char*>(arena->Allocate(nodeHeaderSize + size));
+    *reinterpret_cast<NodeArena**>(p) = arena;
+    return p + nodeHeaderSize;
+}
+
+void Node::operator delete(void* ptr)
+{
+    if (!ptr) return;
+    char* p = static_cast<char*>(ptr) - nodeHeaderSize;
+    if (*reinterpret_cast<NodeArena**>(p) == nullptr)
+    {
+        ::operator delete(p);
+    }
+}
+
+void Node::operator delete(void* ptr, NodeArena* arena)
+{
+    Node::operator delete(ptr);
+}
+
 std::u32string Node::Prefix() const
 {
     if (nodeType == NodeType::elementNode || nodeType == NodeType::attributeNode)
     {
-        auto colonPos = name.find(':');
+        auto colonPos = name->find(':');
         if (colonPos != std::u32string::npos)
         {
-            return name.substr(0, colonPos);
+            return name->substr(0, colonPos);
         }
     }
     return std::u32string();
@@ -65,25 +113,32 @@ void Node::SetPrefix(const std::u32string& prefix)
 {
     if (nodeType == NodeType::elementNode || nodeType == NodeType::attributeNode)
     {
-        auto colonPos = name.find(':');
+        std::u32string newName;
+        auto colonPos = name->find(':');
         if (prefix.empty())
         {
             if (colonPos != std::u32string::npos)
             {
-                name = name.substr(colonPos + 1);
+                newName = name->substr(colonPos + 1);
+            }
+            else
+            {
+                newName = *name;
             }
         }
         else
         {
             if (colonPos != std::u32string::npos)
             {
-                name = prefix + U":" + name.substr(colonPos + 1);
+                newName = prefix + U":" + name->substr(colonPos + 1);
             }
             else
             {
-                name = prefix + U":" + name;
+                newName = prefix + U":" + *name;
             }
         }
+        ownName = newName;
+        name = &ownName;
     }
     else
     {
@@ -95,14 +150,14 @@ std::u32string Node::LocalName() const
 {
     if (nodeType == NodeType::elementNode || nodeType == NodeType::attributeNode)
     {
-        auto colonPos = name.find(':');
+        auto colonPos = name->find(':');
         if (colonPos != std::u32string::npos)
         {
-            return name.substr(colonPos + 1);
+            return name->substr(colonPos + 1);
         }
         else
         {
-            return name;
+            return *name;
         }
     }
     else
@@ -246,7 +301,16 @@ ParentNode::ParentNode(NodeType nodeType_, const std::u32string& name_) : Node(n
 {
 }
 
+ParentNode::ParentNode(NodeType nodeType_, const std::u32string* internedName_) : Node(nodeType_, internedName_), firstChild(nullptr), lastChild(nullptr)
+{
+}
+
 ParentNode::~ParentNode()
+{
+    DeleteChildren();
+}
+
+void ParentNode::DeleteChildren()
 {
     Node* child = firstChild;
     while (child != nullptr)
@@ -255,6 +319,8 @@ ParentNode::~ParentNode()
         child = child->NextSibling();
         delete toDel;
     }
+    firstChild = nullptr;
+    lastChild = nullptr;
 }
 
 NodeList ParentNode::ChildNodes() const
@@ -263,7 +329,7 @@ NodeList ParentNode::ChildNodes() const
     Node* child = firstChild;
     while (child != nullptr)
     {
-        result.InternalAddNode(child);
+        result.InternalAppendNode(child);
         child = child->NextSibling();
     }
     return result;
@@ -493,4 +559,11 @@ void NodeList::InternalAddNode(Node* node)
     }
 }
 
+// Appends the node without checking whether the list already contains it. For callers that produce distinct nodes only.
+
+void NodeList::InternalAppendNode(Node* node)
+{
+    nodes.push_back(node);
+}
+
 } } // namespace sngxml::dom
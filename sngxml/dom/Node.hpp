@@ -21,6 +21,7 @@ enum class NodeType
 };
 
 class Node;
+class NodeArena;
 class ParentNode;
 class Document;
 class NodeList;
@@ -63,14 +64,19 @@ class SNGXML_DOM_API Node
 {
 public:
     Node(NodeType nodeType_, const std::u32string& name_);
+    Node(NodeType nodeType_, const std::u32string* internedName_);
     virtual ~Node();
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, NodeArena* arena);
+    static void operator delete(void* ptr);
+    static void operator delete(void* ptr, NodeArena* arena);
     Node(const Node&) = delete;
     Node& operator=(const Node&) = delete;
     Node(Node&&) = delete;
     Node& operator=(Node&&) = delete;
     virtual std::unique_ptr<Node> CloneNode(bool deep) = 0;
     NodeType GetNodeType() const { return nodeType; }
-    const std::u32string& Name() const { return name; }
+    const std::u32string& Name() const { return *name; }
     const std::u32string& NamespaceUri() const { return namespaceUri; }
     std::u32string Prefix() const;
     void SetPrefix(const std::u32string& prefix);
@@ -105,7 +111,8 @@ public:
     void InternalSetNamespaceUri(const std::u32string& namespaceUri_);
 private:
     NodeType nodeType;
-    std::u32string name;
+    std::u32string ownName;
+    const std::u32string* name;
     std::u32string namespaceUri;
     ParentNode* parent;
     Node* previousSibling;
@@ -117,6 +124,7 @@ class SNGXML_DOM_API ParentNode : public Node
 {
 public:
     ParentNode(NodeType nodeType_, const std::u32string& name_);
+    ParentNode(NodeType nodeType_, const std::u32string* internedName_);
     ~ParentNode() override;
     ParentNode(const Node&) = delete;
     ParentNode& operator=(const Node&) = delete;
@@ -138,6 +146,8 @@ public:
     void WalkDescendantOrSelf(NodeOp& nodeOp) override;
     void WalkPreceding(NodeOp& nodeOp) override;
     void WalkPrecedingOrSelf(NodeOp& nodeOp) override;
+protected:
+    void DeleteChildren();
 private:
     Node* firstChild;
     Node* lastChild;
@@ -150,6 +160,7 @@ public:
     Node* operator[](int index) const { return nodes[index]; }
     int Length() const { return nodes.size(); }
     void InternalAddNode(Node* node);
+    void InternalAppendNode(Node* node);
 private:
     std::vector<Node*> nodes;
 };
@@ -0,0 +1,45 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/dom/NodeArena.hpp>
+#include <cstddef>
+
+namespace sngxml { namespace dom {
+
+const size_t arenaBlockSize = 64 * 1024;
+const size_t arenaAlignment = alignof(std::max_align_t);
+
+NodeArena::NodeArena() : pos(nullptr), end(nullptr), allocatedBytes(0)
+{
+}
+
+// Allocations larger than a quarter of a block get a block of their own, so that a large allocation does not waste the rest of the current block.
+
+void* NodeArena::Allocate(size_t size)
+{
+    size = (size + arenaAlignment - 1) & ~(arenaAlignment - 1);
+    allocatedBytes += size;
+    if (size > arenaBlockSize / 4)
+    {
+        blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+        return blocks.back().get();
+    }
+    if (static_cast<size_t>(end - pos) < size)
+    {
+        blocks.push_back(std::unique_ptr<char[]>(new char[arenaBlockSize]));
+        pos = blocks.back().get();
+        end = pos + arenaBlockSize;
+    }
+    void* p = pos;
+    pos += size;
+    return p;
+}
+
+const std::u32string* NodeArena::Intern(const std::u32string& name)
+{
+    return &*names.insert(name).first;
+}
+
+} } // namespace sngxml::dom
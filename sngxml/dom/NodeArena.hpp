@@ -0,0 +1,40 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_DOM_NODE_ARENA_INCLUDED
+#define SNGXML_DOM_NODE_ARENA_INCLUDED
+#include <sngxml/dom/DomApi.hpp>
+#include <string>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <stdint.h>
+
+namespace sngxml { namespace dom {
+
+// Allocates the nodes of a document from large blocks and keeps one copy of each element and attribute name used in the document.
+// The blocks are released all at once when the arena is destroyed together with its document.
+// A node allocated from an arena must not outlive the arena, even if it has been removed from the document.
+
+class SNGXML_DOM_API NodeArena
+{
+public:
+    NodeArena();
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    void* Allocate(size_t size);
+    const std::u32string* Intern(const std::u32string& name);
+    int64_t AllocatedBytes() const { return allocatedBytes; }
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* pos;
+    char* end;
+    int64_t allocatedBytes;
+    std::unordered_set<std::u32string> names;
+};
+
+} } // namespace sngxml::dom
+
+#endif // SNGXML_DOM_NODE_ARENA_INCLUDED
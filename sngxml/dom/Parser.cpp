@@ -23,7 +23,7 @@ using namespace soulng::unicode;
 class SNGXML_DOM_API DomDocumentHandler : public XmlContentHandler
 {
 public:
-    DomDocumentHandler();
+    DomDocumentHandler(Flags flags_);
     std::unique_ptr<Document> GetDocument();
     void StartDocument() override;
     void EndDocument() override;
@@ -38,6 +38,7 @@ public:
     void EndElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName) override;
     void SkippedEntity(const std::u32string& entityName) override;
 private:
+    Flags flags;
     std::unique_ptr<Document> document;
     std::unique_ptr<Element> currentElement;
     std::stack<std::unique_ptr<Element>> elementStack;
@@ -46,7 +47,7 @@ private:
     void AddTextContent(bool addSpace);
 };
 
-DomDocumentHandler::DomDocumentHandler() : document(new Document())
+DomDocumentHandler::DomDocumentHandler(Flags flags_) : flags(flags_), document(new Document((flags & Flags::arena) != Flags::none))
 {
 }
 
@@ -71,7 +72,7 @@ void DomDocumentHandler::AddTextContent(bool addSpace)
             {
                 text.append(1, ' ');
             }
-            std::unique_ptr<dom::Text> textNode(new dom::Text(text));
+            std::unique_ptr<dom::Text> textNode = document->CreateTextNode(text);
             currentElement->AppendChild(std::move(textNode));
         }
     }
@@ -111,7 +112,7 @@ void DomDocumentHandler::Text(const std::u32string& text)
 void DomDocumentHandler::Comment(const std::u32string& comment)
 {
     AddTextContent();
-    std::unique_ptr<dom::Comment> commentNode(new dom::Comment(comment));
+    std::unique_ptr<dom::Comment> commentNode(new (document->Arena()) dom::Comment(comment));
     if (currentElement)
     {
         currentElement->AppendChild(std::move(commentNode));
@@ -125,7 +126,7 @@ void DomDocumentHandler::Comment(const std::u32string& comment)
 void DomDocumentHandler::PI(const std::u32string& target, const std::u32string& data)
 {
     AddTextContent();
-    std::unique_ptr<dom::ProcessingInstruction> processingInstructionNode(new dom::ProcessingInstruction(target, data));
+    std::unique_ptr<dom::ProcessingInstruction> processingInstructionNode(new (document->Arena()) dom::ProcessingInstruction(target, data));
     if (currentElement)
     {
         currentElement->AppendChild(std::move(processingInstructionNode));
@@ -139,7 +140,7 @@ void DomDocumentHandler::PI(const std::u32string& target, const std::u32string&
 void DomDocumentHandler::CDataSection(const std::u32string& data)
 {
     AddTextContent();
-    std::unique_ptr<dom::CDataSection> cdataSection(new dom::CDataSection(data));
+    std::unique_ptr<dom::CDataSection> cdataSection(new (document->Arena()) dom::CDataSection(data));
     if (currentElement)
     {
         currentElement->AppendChild(std::move(cdataSection));
@@ -154,12 +155,22 @@ void DomDocumentHandler::StartElement(const std::u32string& namespaceUri, const
 {
     AddTextContent(true);
     elementStack.push(std::move(currentElement));
-    std::map<std::u32string, std::unique_ptr<Attr>> attrs;
+    currentElement = document->CreateElement(qualifiedName);
+    currentElement->ReserveAttributes(static_cast<int>(attributes.Count()));
+    bool utf8 = (flags & Flags::utf8) != Flags::none;
     for (const Attribute& attr : attributes)
     {
-        attrs[attr.QualifiedName()] = std::unique_ptr<Attr>(new Attr(attr.QualifiedName(), attr.Value()));
+        if (utf8)
+        {
+            std::unique_ptr<Attr> attrNode = document->CreateAttribute(attr.QualifiedName(), std::u32string());
+            attrNode->SetUtf8Value(ToUtf8(attr.Value()));
+            currentElement->AddAttribute(std::move(attrNode));
+        }
+        else
+        {
+            currentElement->AddAttribute(document->CreateAttribute(attr.QualifiedName(), attr.Value()));
+        }
     }
-    currentElement.reset(new Element(qualifiedName, std::move(attrs)));
     currentElement->SetSourcePos(sourcePos);
     currentElement->InternalSetOwnerDocument(document.get());
     if (!namespaceUri.empty())
@@ -196,7 +207,7 @@ std::unique_ptr<Document> ParseDocument(const std::u32string& content, const std
 
 std::unique_ptr<Document> ParseDocument(const std::u32string& content, const std::string& systemId, Flags flags)
 {
-    DomDocumentHandler domDocumentHandler;
+    DomDocumentHandler domDocumentHandler(flags);
     sngxml::xml::Flags xmlFlags = sngxml::xml::Flags::none;
     if ((flags & Flags::debug) != Flags::none)
     {
@@ -211,12 +222,29 @@ std::unique_ptr<Document> ReadDocument(const std::string& fileName)
     return ReadDocument(fileName, Flags::none);
 }
 
+// With Flags::streaming the file is parsed from a memory mapping without converting it to UTF-32 first.
+// With Flags::arena the nodes of the document are allocated from an arena owned by the document, see NodeArena.
+// With Flags::utf8 attribute values are stored in UTF-8 for callers that read them with the std::string_view accessors.
+
 std::unique_ptr<Document> ReadDocument(const std::string& fileName, Flags flags)
 {
+    if ((flags & Flags::streaming) != Flags::none)
+    {
+        DomDocumentHandler domDocumentHandler(flags);
+        ParseXmlFile(fileName, &domDocumentHandler, sngxml::xml::Flags::streaming);
+        return domDocumentHandler.GetDocument();
+    }
     std::u32string content = ToUtf32(ReadFile(fileName));
     return ParseDocument(content, fileName, flags);
 }
 
+std::unique_ptr<Document> ReadDocument(soulng::util::Stream& stream, const std::string& systemId)
+{
+    DomDocumentHandler domDocumentHandler(Flags::none);
+    ParseXmlStream(stream, systemId, &domDocumentHandler);
+    return domDocumentHandler.GetDocument();
+}
+
 void SendDocument(soulng::util::TcpSocket& socket, Document& document)
 {
     std::stringstream sstream;
@@ -7,12 +7,13 @@
 #define SNGXML_DOM_PARSER_INCLUDED
 #include <sngxml/dom/Document.hpp>
 #include <soulng/util/SocketFwd.hpp>
+#include <soulng/util/Stream.hpp>
 
 namespace sngxml { namespace dom {
 
 enum class Flags : int
 {
-    none = 0, debug = 1 << 0
+    none = 0, debug = 1 << 0, streaming = 1 << 1, arena = 1 << 2, utf8 = 1 << 3
 };
 
 inline Flags operator&(Flags flags, Flags flag)
@@ -34,6 +35,7 @@ SNGXML_DOM_API std::unique_ptr<Document> ParseDocument(const std::u32string& con
 SNGXML_DOM_API std::unique_ptr<Document> ParseDocument(const std::u32string& content, const std::string& systemId, Flags flags);
 SNGXML_DOM_API std::unique_ptr<Document> ReadDocument(const std::string& fileName);
 SNGXML_DOM_API std::unique_ptr<Document> ReadDocument(const std::string& fileName, Flags flags);
+SNGXML_DOM_API std::unique_ptr<Document> ReadDocument(soulng::util::Stream& stream, const std::string& systemId);
 SNGXML_DOM_API void SendDocument(soulng::util::TcpSocket& socket, Document& document);
 SNGXML_DOM_API std::unique_ptr<Document> ReceiveDocument(soulng::util::TcpSocket& socket);
 
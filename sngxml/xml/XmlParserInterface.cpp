@@ -5,6 +5,7 @@
 
 #include <sngxml/xml/XmlParserInterface.hpp>
 #include <sngxml/xml/XmlParser.hpp>
+#include <sngxml/xml/XmlStreamParser.hpp>
 #include <sngxml/xml/Rules.hpp>
 #include <soulng/lexer/TrivialLexer.hpp>
 #include <soulng/lexer/XmlParsingLog.hpp>
@@ -17,6 +18,10 @@ namespace sngxml { namespace xml {
 using namespace soulng::util;
 using namespace soulng::unicode;
 
+// The trivial lexer makes a token of each character, so only a window of the most recent tokens is kept in memory.
+
+const int64_t xmlTokenWindowSize = 4096;
+
 void ParseXmlFile(const std::string& xmlFileName, XmlContentHandler* contentHandler)
 {
     ParseXmlFile(xmlFileName, contentHandler, Flags::none);
@@ -24,6 +29,13 @@ void ParseXmlFile(const std::string& xmlFileName, XmlContentHandler* contentHand
 
 void ParseXmlFile(const std::string& xmlFileName, XmlContentHandler* contentHandler, Flags flags)
 {
+    if ((flags & Flags::streaming) != Flags::none)
+    {
+        MappedInputFile xmlFile(xmlFileName);
+        XmlStreamParser xmlStreamParser(xmlFile.Begin(), xmlFile.End(), xmlFileName, contentHandler);
+        xmlStreamParser.Parse();
+        return;
+    }
     std::string xmlContent = ReadFile(xmlFileName);
     ParseXmlContent(xmlContent, xmlFileName, contentHandler, flags);
 }
@@ -35,9 +47,21 @@ void ParseXmlContent(const std::string& xmlContent, const std::string& systemId,
 
 void ParseXmlContent(const std::string& xmlContent, const std::string& systemId, XmlContentHandler* contentHandler, Flags flags)
 {
+    if ((flags & Flags::streaming) != Flags::none)
+    {
+        XmlStreamParser xmlStreamParser(xmlContent.data(), xmlContent.data() + xmlContent.size(), systemId, contentHandler);
+        xmlStreamParser.Parse();
+        return;
+    }
     ParseXmlContent(ToUtf32(xmlContent), systemId, contentHandler, flags);
 }
 
+void ParseXmlStream(soulng::util::Stream& stream, const std::string& systemId, XmlContentHandler* contentHandler)
+{
+    XmlStreamParser xmlStreamParser(stream, systemId, contentHandler);
+    xmlStreamParser.Parse();
+}
+
 void ParseXmlContent(const std::u32string& xmlContent, const std::string& systemId, XmlContentHandler* contentHandler)
 {
     ParseXmlContent(xmlContent, systemId, contentHandler, Flags::none);
@@ -48,6 +72,7 @@ void ParseXmlContent(const std::u32string& xmlContent, const std::string& system
     soulng::lexer::XmlParsingLog debugLog(std::cerr);
     TrivialLexer xmlLexer(xmlContent, systemId, 0);
     xmlLexer.SetFlag(soulng::lexer::LexerFlags::farthestError);
+    xmlLexer.SetTokenWindow(xmlTokenWindowSize);
 	xmlLexer.SetRuleNameVecPtr(GetRuleNameVecPtr());
     if ((flags & Flags::debug) != Flags::none)
     {
@@ -11,12 +11,13 @@
 #ifndef SNGXML_XML_XML_PARSER
 #define SNGXML_XML_XML_PARSER
 #include <sngxml/xml/XmlContentHandler.hpp>
+#include <soulng/util/Stream.hpp>
 
 namespace sngxml { namespace xml {
 
 enum class Flags : int
 {
-    none = 0, debug = 1 << 0
+    none = 0, debug = 1 << 0, streaming = 1 << 1
 };
 
 inline Flags operator&(Flags flags, Flags flag)
@@ -36,6 +37,8 @@ inline Flags operator~(Flags flags)
 
 //  ==================================================================================
 //  ParseXmlFile parses given UTF-8 encoded XML file using given content handler.
+//  With Flags::streaming the file is mapped to memory and parsed with XmlStreamParser
+//  instead of being read and converted to UTF-32 as a whole.
 //  ==================================================================================
 
 SNGXML_XML_API void ParseXmlFile(const std::string& xmlFileName, XmlContentHandler* contentHandler);
@@ -50,6 +53,13 @@ SNGXML_XML_API void ParseXmlFile(const std::string& xmlFileName, XmlContentHandl
 SNGXML_XML_API void ParseXmlContent(const std::string& xmlContent, const std::string& systemId, XmlContentHandler* contentHandler);
 SNGXML_XML_API void ParseXmlContent(const std::string& xmlContent, const std::string& systemId, XmlContentHandler* contentHandler, Flags flags);
 
+//  ==================================================================================
+//  ParseXmlStream parses UTF-8 encoded XML read from given stream in chunks using
+//  XmlStreamParser. systemId is used for error messages only.
+//  ==================================================================================
+
+SNGXML_XML_API void ParseXmlStream(soulng::util::Stream& stream, const std::string& systemId, XmlContentHandler* contentHandler);
+
 //  ===================================================================================
 //  ParseXmlContent parses given UTF-32 encoded XML string using given content handler.
 //  systemId is used for error messages only. It can be for example a file name or URL 
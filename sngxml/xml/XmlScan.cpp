@@ -0,0 +1,223 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xml/XmlScan.hpp>
+#include <cstdint>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define SNGXML_XML_SCAN_SIMD
+#define SNGXML_XML_SCAN_AVX2_TARGET
+#elif defined(__GNUC__) && defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SNGXML_XML_SCAN_SIMD
+#define SNGXML_XML_SCAN_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace sngxml { namespace xml {
+
+// Finds the first byte that equals a, b or c or is not ASCII.
+
+const char* FindStopScalar(const char* p, const char* end, char a, char b, char c)
+{
+    while (p != end)
+    {
+        char x = *p;
+        if (x == a || x == b || x == c || static_cast<unsigned char>(x) >= 0x80) break;
+        ++p;
+    }
+    return p;
+}
+
+const char* SkipSpaceScalar(const char* p, const char* end)
+{
+    while (p != end)
+    {
+        char x = *p;
+        if (x != ' ' && x != '\t' && x != '\r' && x != '\n') break;
+        ++p;
+    }
+    return p;
+}
+
+#ifdef SNGXML_XML_SCAN_SIMD
+
+int LowestBit(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// AVX2 needs support from both the processor and the operating system, which must save the YMM registers.
+
+bool HasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    if ((ecx & (1u << 27)) == 0 || (ecx & (1u << 28)) == 0) return false;
+    unsigned int xcr0 = 0;
+    unsigned int xcr0High = 0;
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+    if ((xcr0 & 6) != 6) return false;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & (1u << 5)) != 0;
+#endif
+}
+
+bool UseAvx2()
+{
+    static bool hasAvx2 = HasAvx2();
+    return hasAvx2;
+}
+
+// A byte that is not ASCII has its high bit set, so it is included in the mask by OR'ing the input into the comparison result.
+
+const char* FindStopSse2(const char* p, const char* end, char a, char b, char c)
+{
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    while (end - p >= 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb)), _mm_cmpeq_epi8(x, vc));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(stop, x)));
+        if (mask != 0)
+        {
+            return p + LowestBit(mask);
+        }
+        p += 16;
+    }
+    return FindStopScalar(p, end, a, b, c);
+}
+
+const char* SkipSpaceSse2(const char* p, const char* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (end - p >= 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab)), _mm_or_si128(_mm_cmpeq_epi8(x, cr), _mm_cmpeq_epi8(x, lf)));
+        uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(isSpace)) & 0xFFFF;
+        if (mask != 0)
+        {
+            return p + LowestBit(mask);
+        }
+        p += 16;
+    }
+    return SkipSpaceScalar(p, end);
+}
+
+SNGXML_XML_SCAN_AVX2_TARGET const char* FindStopAvx2(const char* p, const char* end, char a, char b, char c)
+{
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    const __m256i vc = _mm256_set1_epi8(c);
+    while (end - p >= 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i stop = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, va), _mm256_cmpeq_epi8(x, vb)), _mm256_cmpeq_epi8(x, vc));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(stop, x)));
+        if (mask != 0)
+        {
+            return p + LowestBit(mask);
+        }
+        p += 32;
+    }
+    return FindStopSse2(p, end, a, b, c);
+}
+
+SNGXML_XML_SCAN_AVX2_TARGET const char* SkipSpaceAvx2(const char* p, const char* end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    while (end - p >= 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i isSpace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, space), _mm256_cmpeq_epi8(x, tab)), _mm256_or_si256(_mm256_cmpeq_epi8(x, cr), _mm256_cmpeq_epi8(x, lf)));
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(isSpace));
+        if (mask != 0)
+        {
+            return p + LowestBit(mask);
+        }
+        p += 32;
+    }
+    return SkipSpaceSse2(p, end);
+}
+
+#endif
+
+const char* FindStop(const char* begin, const char* end, char a, char b, char c)
+{
+#ifdef SNGXML_XML_SCAN_SIMD
+    if (UseAvx2())
+    {
+        return FindStopAvx2(begin, end, a, b, c);
+    }
+    return FindStopSse2(begin, end, a, b, c);
+#else
+    return FindStopScalar(begin, end, a, b, c);
+#endif
+}
+
+const char* ScanCharData(const char* begin, const char* end)
+{
+    return FindStop(begin, end, '<', '&', '&');
+}
+
+const char* ScanAttributeValue(const char* begin, const char* end, char quote)
+{
+    return FindStop(begin, end, quote, '<', '&');
+}
+
+// White space runs are mostly short: a separator between attributes or the indentation of a line. The first bytes are therefore examined one at a time,
+// and only a run longer than that is scanned with vector instructions.
+
+const int scalarSpacePrefixLength = 8;
+
+const char* ScanSpace(const char* begin, const char* end)
+{
+    const char* prefixEnd = end - begin > scalarSpacePrefixLength ? begin + scalarSpacePrefixLength : end;
+    begin = SkipSpaceScalar(begin, prefixEnd);
+    if (begin != prefixEnd || begin == end)
+    {
+        return begin;
+    }
+#ifdef SNGXML_XML_SCAN_SIMD
+    if (UseAvx2())
+    {
+        return SkipSpaceAvx2(begin, end);
+    }
+    return SkipSpaceSse2(begin, end);
+#else
+    return SkipSpaceScalar(begin, end);
+#endif
+}
+
+} } // namespace sngxml::xml
@@ -0,0 +1,34 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_XML_XML_SCAN
+#define SNGXML_XML_XML_SCAN
+#include <sngxml/xml/XmlApi.hpp>
+
+namespace sngxml { namespace xml {
+
+//  ===================================================================================
+//  Functions that find the end of a run of UTF-8 input the parser can consume in one
+//  step. Each function returns a pointer to the first byte in [begin, end) that ends
+//  the run, or end if there is none. Bytes of non-ASCII characters always end a run,
+//  so a run contains only ASCII characters. On x64 the input is examined 16 bytes at
+//  a time with SSE2, or 32 bytes at a time with AVX2 when the processor supports it.
+//  ===================================================================================
+
+//  ScanCharData: a run of character data ends at '<' or '&'.
+
+SNGXML_XML_API const char* ScanCharData(const char* begin, const char* end);
+
+//  ScanAttributeValue: a run of an attribute value ends at the quote character, '<' or '&'.
+
+SNGXML_XML_API const char* ScanAttributeValue(const char* begin, const char* end, char quote);
+
+//  ScanSpace: a run of white space ends at a byte other than space, tab, carriage return or line feed.
+
+SNGXML_XML_API const char* ScanSpace(const char* begin, const char* end);
+
+} } // namespace sngxml::xml
+
+#endif // SNGXML_XML_XML_SCAN
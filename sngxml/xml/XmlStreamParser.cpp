@@ -0,0 +1,797 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xml/XmlStreamParser.hpp>
+#include <sngxml/xml/XmlProcessor.hpp>
+#include <sngxml/xml/XmlScan.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <cctype>
+#include <cstring>
+
+namespace sngxml { namespace xml {
+
+using namespace soulng::util;
+using namespace soulng::unicode;
+
+const int64_t streamBufferSize = 64 * 1024;
+
+bool IsXmlSpace(char32_t c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool IsNameStartChar(char32_t c)
+{
+    if (c < 0x80)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == ':' || c == '_';
+    }
+    return (c >= 0xC0 && c <= 0xD6) || (c >= 0xD8 && c <= 0xF6) || (c >= 0xF8 && c <= 0x2FF) || (c >= 0x370 && c <= 0x37D) || (c >= 0x37F && c <= 0x1FFF) ||
+        (c >= 0x200C && c <= 0x200D) || (c >= 0x2070 && c <= 0x218F) || (c >= 0x2C00 && c <= 0x2FEF) || (c >= 0x3001 && c <= 0xD7FF) || (c >= 0xF900 && c <= 0xFDCF) ||
+        (c >= 0xFDF0 && c <= 0xFFFD) || (c >= 0x10000 && c <= 0xEFFFF);
+}
+
+bool IsNameChar(char32_t c)
+{
+    if (IsNameStartChar(c)) return true;
+    return c == '-' || c == '.' || (c >= '0' && c <= '9') || c == 0xB7 || (c >= 0x300 && c <= 0x36F) || (c >= 0x203F && c <= 0x2040);
+}
+
+bool IsXmlChar(char32_t c)
+{
+    return c == 0x9 || c == 0xA || c == 0xD || (c >= 0x20 && c <= 0xD7FF) || (c >= 0xE000 && c <= 0xFFFD) || (c >= 0x10000 && c <= 0x10FFFF);
+}
+
+void AppendAscii(std::u32string& s, const char* begin, const char* end)
+{
+    size_t n = s.length();
+    s.resize(n + (end - begin));
+    char32_t* p = &s[n];
+    while (begin != end)
+    {
+        *p++ = static_cast<char32_t>(*begin++);
+    }
+}
+
+const std::u32string* GetPredefinedEntityValue(const std::u32string& entityName)
+{
+    static const std::u32string quot = U"\"";
+    static const std::u32string amp = U"&";
+    static const std::u32string apos = U"'";
+    static const std::u32string lt = U"<";
+    static const std::u32string gt = U">";
+    if (entityName == U"quot") return &quot;
+    if (entityName == U"amp") return &amp;
+    if (entityName == U"apos") return &apos;
+    if (entityName == U"lt") return &lt;
+    if (entityName == U"gt") return &gt;
+    return nullptr;
+}
+
+NamespaceBinding::NamespaceBinding(const std::u32string& prefix_, bool bound_, const std::u32string& namespaceUri_) : prefix(prefix_), bound(bound_), namespaceUri(namespaceUri_)
+{
+}
+
+XmlStreamParser::XmlStreamParser(const char* begin_, const char* end_, const std::string& systemId_, XmlContentHandler* contentHandler_) :
+    stream(nullptr), pos(begin_), end(end_), systemId(systemId_), contentHandler(contentHandler_), line(1), col(1)
+{
+}
+
+XmlStreamParser::XmlStreamParser(soulng::util::Stream& stream_, const std::string& systemId_, XmlContentHandler* contentHandler_) :
+    stream(&stream_), buffer(streamBufferSize), pos(buffer.data()), end(buffer.data()), systemId(systemId_), contentHandler(contentHandler_), line(1), col(1)
+{
+}
+
+void XmlStreamParser::Parse()
+{
+    if (StartsWith("\xEF\xBB\xBF"))
+    {
+        pos += 3;
+    }
+    contentHandler->StartDocument();
+    if (StartsWith("<?xml") && Fill(6) && IsXmlSpace(static_cast<unsigned char>(pos[5])))
+    {
+        ParseXmlDecl();
+    }
+    ParseMisc(true);
+    if (!StartsWith("<"))
+    {
+        Error("document element expected");
+    }
+    ParseElement();
+    ParseMisc(false);
+    if (!AtEnd())
+    {
+        Error("unexpected content after document element");
+    }
+    contentHandler->EndDocument();
+}
+
+// When reading from a stream, the unread bytes are moved to the start of the buffer and the rest of the buffer is filled from the stream.
+
+bool XmlStreamParser::Fill(int64_t count)
+{
+    if (end - pos >= count) return true;
+    if (!stream) return false;
+    int64_t remaining = end - pos;
+    std::memmove(buffer.data(), pos, remaining);
+    pos = buffer.data();
+    end = pos + remaining;
+    while (end - pos < count)
+    {
+        int64_t offset = end - pos;
+        int64_t bytesRead = stream->Read(reinterpret_cast<uint8_t*>(buffer.data() + offset), static_cast<int64_t>(buffer.size()) - offset);
+        if (bytesRead <= 0)
+        {
+            stream = nullptr;
+            return false;
+        }
+        end += bytesRead;
+    }
+    return true;
+}
+
+bool XmlStreamParser::AtEnd()
+{
+    return !Fill(1);
+}
+
+bool XmlStreamParser::StartsWith(const char* s)
+{
+    int64_t n = std::strlen(s);
+    return Fill(n) && std::memcmp(pos, s, n) == 0;
+}
+
+char32_t XmlStreamParser::PeekChar(int& length)
+{
+    if (!Fill(1))
+    {
+        Error("unexpected end of file");
+    }
+    unsigned char b = static_cast<unsigned char>(*pos);
+    if (b < 0x80)
+    {
+        length = 1;
+        return b;
+    }
+    char32_t c = 0;
+    if ((b & 0xE0) == 0xC0)
+    {
+        c = b & 0x1F;
+        length = 2;
+    }
+    else if ((b & 0xF0) == 0xE0)
+    {
+        c = b & 0x0F;
+        length = 3;
+    }
+    else if ((b & 0xF8) == 0xF0)
+    {
+        c = b & 0x07;
+        length = 4;
+    }
+    else
+    {
+        Error("invalid UTF-8 sequence");
+    }
+    if (!Fill(length))
+    {
+        Error("invalid UTF-8 sequence");
+    }
+    for (int i = 1; i < length; ++i)
+    {
+        unsigned char x = static_cast<unsigned char>(pos[i]);
+        if ((x & 0xC0) != 0x80)
+        {
+            Error("invalid UTF-8 sequence");
+        }
+        c = (c << 6) | (x & 0x3F);
+    }
+    return c;
+}
+
+char32_t XmlStreamParser::GetChar()
+{
+    int length = 0;
+    char32_t c = PeekChar(length);
+    Advance(length, c);
+    return c;
+}
+
+void XmlStreamParser::Advance(int length, char32_t c)
+{
+    pos += length;
+    if (c == '\n')
+    {
+        ++line;
+        col = 1;
+    }
+    else
+    {
+        ++col;
+    }
+}
+
+// Advances over a run of ASCII characters found by one of the scanning functions of XmlScan.hpp.
+
+void XmlStreamParser::AdvanceRun(const char* runEnd)
+{
+    int64_t n = runEnd - pos;
+    const char* lineFeed = static_cast<const char*>(std::memchr(pos, '\n', n));
+    if (!lineFeed)
+    {
+        col += static_cast<int>(n);
+    }
+    else
+    {
+        const char* lastLineFeed = lineFeed;
+        for (const char* p = lineFeed; p != runEnd; ++p)
+        {
+            if (*p == '\n')
+            {
+                ++line;
+                lastLineFeed = p;
+            }
+        }
+        col = 1 + static_cast<int>(runEnd - lastLineFeed - 1);
+    }
+    pos = runEnd;
+}
+
+void XmlStreamParser::Skip(const char* s)
+{
+    int64_t n = std::strlen(s);
+    pos += n;
+    col += static_cast<int>(n);
+}
+
+bool XmlStreamParser::SkipSpace()
+{
+    bool skipped = false;
+    while (Fill(1))
+    {
+        const char* runEnd = ScanSpace(pos, end);
+        if (runEnd == pos) break;
+        AdvanceRun(runEnd);
+        skipped = true;
+    }
+    return skipped;
+}
+
+void XmlStreamParser::Expect(const char* s)
+{
+    if (!StartsWith(s))
+    {
+        Error("'" + std::string(s) + "' expected");
+    }
+    Skip(s);
+}
+
+std::u32string XmlStreamParser::ParseName()
+{
+    std::u32string name;
+    int length = 0;
+    char32_t c = AtEnd() ? 0 : PeekChar(length);
+    if (!IsNameStartChar(c))
+    {
+        Error("name expected");
+    }
+    while (IsNameChar(c))
+    {
+        name.append(1, c);
+        Advance(length, c);
+        if (AtEnd()) break;
+        c = PeekChar(length);
+    }
+    return name;
+}
+
+void XmlStreamParser::ParseQuoted(std::u32string& value)
+{
+    char32_t quote = GetChar();
+    if (quote != '"' && quote != '\'')
+    {
+        Error("quoted value expected");
+    }
+    char32_t c = GetChar();
+    while (c != quote)
+    {
+        value.append(1, c);
+        c = GetChar();
+    }
+}
+
+void XmlStreamParser::ParseXmlDecl()
+{
+    Skip("<?xml");
+    SkipSpace();
+    Expect("version");
+    SkipSpace();
+    Expect("=");
+    SkipSpace();
+    std::u32string version;
+    ParseQuoted(version);
+    contentHandler->Version(version);
+    SkipSpace();
+    if (StartsWith("encoding"))
+    {
+        Skip("encoding");
+        SkipSpace();
+        Expect("=");
+        SkipSpace();
+        std::u32string encoding;
+        ParseQuoted(encoding);
+        contentHandler->Encoding(encoding);
+        SkipSpace();
+    }
+    if (StartsWith("standalone"))
+    {
+        Skip("standalone");
+        SkipSpace();
+        Expect("=");
+        SkipSpace();
+        std::u32string standalone;
+        ParseQuoted(standalone);
+        if (standalone == U"yes")
+        {
+            contentHandler->Standalone(true);
+        }
+        else if (standalone == U"no")
+        {
+            contentHandler->Standalone(false);
+        }
+        else
+        {
+            Error("'yes' or 'no' expected");
+        }
+        SkipSpace();
+    }
+    Expect("?>");
+}
+
+void XmlStreamParser::ParseMisc(bool prolog)
+{
+    while (true)
+    {
+        SkipSpace();
+        if (StartsWith("<!--"))
+        {
+            ParseComment();
+        }
+        else if (StartsWith("<?"))
+        {
+            ParsePI();
+        }
+        else if (prolog && StartsWith("<!DOCTYPE"))
+        {
+            ParseDocTypeDecl();
+            prolog = false;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+// Like the grammar based parser, the document type declaration is checked for balanced brackets and quotes only. Its declarations are not used.
+
+void XmlStreamParser::ParseDocTypeDecl()
+{
+    Skip("<!DOCTYPE");
+    int bracketDepth = 0;
+    while (true)
+    {
+        char32_t c = GetChar();
+        if (c == '"' || c == '\'')
+        {
+            char32_t quote = c;
+            do
+            {
+                c = GetChar();
+            }
+            while (c != quote);
+        }
+        else if (c == '[')
+        {
+            ++bracketDepth;
+        }
+        else if (c == ']')
+        {
+            --bracketDepth;
+        }
+        else if (c == '>' && bracketDepth == 0)
+        {
+            break;
+        }
+    }
+}
+
+void XmlStreamParser::ParseComment()
+{
+    Skip("<!--");
+    std::u32string comment;
+    while (!StartsWith("--"))
+    {
+        comment.append(1, GetChar());
+    }
+    if (!StartsWith("-->"))
+    {
+        Error("'--' not allowed in comment");
+    }
+    Skip("-->");
+    contentHandler->Comment(comment);
+}
+
+void XmlStreamParser::ParsePI()
+{
+    Skip("<?");
+    std::u32string target = ParseName();
+    if (target.length() == 3 && (target[0] == 'x' || target[0] == 'X') && (target[1] == 'm' || target[1] == 'M') && (target[2] == 'l' || target[2] == 'L'))
+    {
+        Error("XML declaration allowed only at the start of the document");
+    }
+    SkipSpace();
+    std::u32string data;
+    while (!StartsWith("?>"))
+    {
+        data.append(1, GetChar());
+    }
+    Skip("?>");
+    contentHandler->PI(target, data);
+}
+
+void XmlStreamParser::ParseCDataSection()
+{
+    Skip("<![CDATA[");
+    std::u32string cdata;
+    while (!StartsWith("]]>"))
+    {
+        cdata.append(1, GetChar());
+    }
+    Skip("]]>");
+    contentHandler->CDataSection(cdata);
+}
+
+void XmlStreamParser::ParseElement()
+{
+    ParseStartTag();
+    while (!elementStack.empty())
+    {
+        ParseCharData();
+        if (AtEnd())
+        {
+            Error("end tag of element '" + ToUtf8(elementStack.back().qualifiedName) + "' expected");
+        }
+        if (StartsWith("</"))
+        {
+            ParseEndTag();
+        }
+        else if (StartsWith("<!--"))
+        {
+            ParseComment();
+        }
+        else if (StartsWith("<![CDATA["))
+        {
+            ParseCDataSection();
+        }
+        else if (StartsWith("<?"))
+        {
+            ParsePI();
+        }
+        else if (StartsWith("<"))
+        {
+            ParseStartTag();
+        }
+        else
+        {
+            ParseReference(nullptr);
+        }
+    }
+}
+
+// Namespace declarations apply to all attributes of the element, so the attributes are collected before their namespace URIs are resolved.
+
+void XmlStreamParser::ParseStartTag()
+{
+    soulng::lexer::SourcePos sourcePos(line, col);
+    Skip("<");
+    ElementScope scope;
+    scope.qualifiedName = ParseName();
+    std::vector<std::pair<std::u32string, std::u32string>> attributeValues;
+    bool emptyElement = false;
+    while (true)
+    {
+        bool space = SkipSpace();
+        if (StartsWith("/>"))
+        {
+            Skip("/>");
+            emptyElement = true;
+            break;
+        }
+        if (StartsWith(">"))
+        {
+            Skip(">");
+            break;
+        }
+        if (!space)
+        {
+            Error("'>' or '/>' expected");
+        }
+        std::u32string attributeName = ParseName();
+        SkipSpace();
+        Expect("=");
+        SkipSpace();
+        std::u32string attributeValue;
+        ParseAttributeValue(attributeValue);
+        attributeValues.push_back(std::make_pair(std::move(attributeName), std::move(attributeValue)));
+    }
+    attributes.Clear();
+    for (const auto& attributeValue : attributeValues)
+    {
+        std::u32string localName;
+        std::u32string prefix;
+        ParseQualifiedName(attributeValue.first, localName, prefix);
+        if (prefix == U"xmlns")
+        {
+            Bind(localName, attributeValue.second, scope);
+        }
+        else if (prefix.empty() && localName == U"xmlns")
+        {
+            Bind(std::u32string(), attributeValue.second, scope);
+        }
+    }
+    for (const auto& attributeValue : attributeValues)
+    {
+        std::u32string localName;
+        std::u32string prefix;
+        ParseQualifiedName(attributeValue.first, localName, prefix);
+        if (prefix == U"xmlns" || (prefix.empty() && localName == U"xmlns")) continue;
+        std::u32string namespaceUri;
+        if (!prefix.empty())
+        {
+            namespaceUri = GetNamespaceUri(prefix);
+        }
+        attributes.Add(Attribute(namespaceUri, localName, attributeValue.first, attributeValue.second));
+    }
+    std::u32string localName;
+    std::u32string prefix;
+    ParseQualifiedName(scope.qualifiedName, localName, prefix);
+    if (prefix == U"xmlns")
+    {
+        Error("'xmlns' prefix cannot be declared for an element");
+    }
+    contentHandler->StartElement(GetNamespaceUri(prefix), localName, scope.qualifiedName, attributes, sourcePos);
+    elementStack.push_back(std::move(scope));
+    if (emptyElement)
+    {
+        EndElement();
+    }
+}
+
+void XmlStreamParser::ParseEndTag()
+{
+    Skip("</");
+    std::u32string qualifiedName = ParseName();
+    SkipSpace();
+    Expect(">");
+    if (qualifiedName != elementStack.back().qualifiedName)
+    {
+        Error("end tag '" + ToUtf8(qualifiedName) + "' does not match start tag '" + ToUtf8(elementStack.back().qualifiedName) + "'");
+    }
+    EndElement();
+}
+
+void XmlStreamParser::EndElement()
+{
+    ElementScope& scope = elementStack.back();
+    std::u32string localName;
+    std::u32string prefix;
+    ParseQualifiedName(scope.qualifiedName, localName, prefix);
+    contentHandler->EndElement(GetNamespaceUri(prefix), localName, scope.qualifiedName);
+    for (auto it = scope.previousBindings.rbegin(); it != scope.previousBindings.rend(); ++it)
+    {
+        if (it->bound)
+        {
+            namespaceUris[it->prefix] = it->namespaceUri;
+        }
+        else
+        {
+            namespaceUris.erase(it->prefix);
+        }
+    }
+    elementStack.pop_back();
+}
+
+// Runs of ASCII characters, which make up most of the text in our documents, are found with ScanCharData and appended without decoding.
+
+void XmlStreamParser::ParseCharData()
+{
+    text.clear();
+    while (Fill(1))
+    {
+        const char* runEnd = ScanCharData(pos, end);
+        if (runEnd != pos)
+        {
+            AppendAscii(text, pos, runEnd);
+            AdvanceRun(runEnd);
+            continue;
+        }
+        if (*pos == '<' || *pos == '&') break;
+        char32_t c = GetChar();
+        if (!IsXmlChar(c))
+        {
+            Error("invalid character");
+        }
+        text.append(1, c);
+    }
+    if (!text.empty())
+    {
+        contentHandler->Text(text);
+    }
+}
+
+void XmlStreamParser::ParseAttributeValue(std::u32string& value)
+{
+    char32_t quote = GetChar();
+    if (quote != '"' && quote != '\'')
+    {
+        Error("attribute value expected");
+    }
+    while (true)
+    {
+        if (Fill(1))
+        {
+            const char* runEnd = ScanAttributeValue(pos, end, static_cast<char>(quote));
+            if (runEnd != pos)
+            {
+                AppendAscii(value, pos, runEnd);
+                AdvanceRun(runEnd);
+                continue;
+            }
+        }
+        int length = 0;
+        char32_t c = PeekChar(length);
+        if (c == quote)
+        {
+            Advance(length, c);
+            break;
+        }
+        else if (c == '<')
+        {
+            Error("'<' not allowed in attribute value");
+        }
+        else if (c == '&')
+        {
+            ParseReference(&value);
+        }
+        else
+        {
+            value.append(1, c);
+            Advance(length, c);
+        }
+    }
+}
+
+// In content a reference is reported as text of its own. In an attribute value the replacement text is appended to the value.
+
+void XmlStreamParser::ParseReference(std::u32string* attributeValue)
+{
+    Skip("&");
+    if (StartsWith("#"))
+    {
+        Skip("#");
+        uint32_t codePoint = 0;
+        int numDigits = 0;
+        if (StartsWith("x"))
+        {
+            Skip("x");
+            while (Fill(1) && std::isxdigit(static_cast<unsigned char>(*pos)))
+            {
+                char d = *pos;
+                if (d >= '0' && d <= '9') codePoint = 16 * codePoint + d - '0';
+                else if (d >= 'a' && d <= 'f') codePoint = 16 * codePoint + 10 + d - 'a';
+                else codePoint = 16 * codePoint + 10 + d - 'A';
+                Advance(1, d);
+                ++numDigits;
+            }
+        }
+        else
+        {
+            while (Fill(1) && *pos >= '0' && *pos <= '9')
+            {
+                codePoint = 10 * codePoint + *pos - '0';
+                Advance(1, *pos);
+                ++numDigits;
+            }
+        }
+        if (numDigits == 0)
+        {
+            Error("character reference expected");
+        }
+        Expect(";");
+        char32_t c = static_cast<char32_t>(codePoint);
+        if (attributeValue)
+        {
+            attributeValue->append(1, c);
+        }
+        else
+        {
+            contentHandler->Text(std::u32string(1, c));
+        }
+    }
+    else
+    {
+        std::u32string entityName = ParseName();
+        Expect(";");
+        const std::u32string* entityValue = GetPredefinedEntityValue(entityName);
+        if (!entityValue)
+        {
+            contentHandler->SkippedEntity(entityName);
+        }
+        else if (attributeValue)
+        {
+            attributeValue->append(*entityValue);
+        }
+        else
+        {
+            contentHandler->Text(*entityValue);
+        }
+    }
+}
+
+void XmlStreamParser::Bind(const std::u32string& prefix, const std::u32string& namespaceUri, ElementScope& scope)
+{
+    auto it = namespaceUris.find(prefix);
+    if (it != namespaceUris.cend())
+    {
+        scope.previousBindings.push_back(NamespaceBinding(prefix, true, it->second));
+    }
+    else
+    {
+        scope.previousBindings.push_back(NamespaceBinding(prefix, false, std::u32string()));
+    }
+    namespaceUris[prefix] = namespaceUri;
+}
+
+std::u32string XmlStreamParser::GetNamespaceUri(const std::u32string& prefix)
+{
+    auto it = namespaceUris.find(prefix);
+    if (it != namespaceUris.cend())
+    {
+        return it->second;
+    }
+    if (prefix.empty())
+    {
+        return std::u32string();
+    }
+    Error("namespace prefix '" + ToUtf8(prefix) + "' not bound to any namespace URI");
+}
+
+void XmlStreamParser::ParseQualifiedName(const std::u32string& qualifiedName, std::u32string& localName, std::u32string& prefix)
+{
+    std::u32string::size_type colon = qualifiedName.find(':');
+    if (colon == std::u32string::npos)
+    {
+        prefix.clear();
+        localName = qualifiedName;
+    }
+    else if (qualifiedName.find(':', colon + 1) != std::u32string::npos)
+    {
+        Error("qualified name '" + ToUtf8(qualifiedName) + "' has more than one ':' character");
+    }
+    else
+    {
+        prefix = qualifiedName.substr(0, colon);
+        localName = qualifiedName.substr(colon + 1);
+    }
+}
+
+void XmlStreamParser::Error(const std::string& message)
+{
+    throw XmlProcessingException("error in '" + systemId + "' at line " + std::to_string(line) + " column " + std::to_string(col) + ": " + message);
+}
+
+} } // namespace sngxml::xml
@@ -0,0 +1,90 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_XML_XML_STREAM_PARSER
+#define SNGXML_XML_XML_STREAM_PARSER
+#include <sngxml/xml/XmlContentHandler.hpp>
+#include <soulng/util/Stream.hpp>
+#include <unordered_map>
+
+namespace sngxml { namespace xml {
+
+struct SNGXML_XML_API NamespaceBinding
+{
+    NamespaceBinding(const std::u32string& prefix_, bool bound_, const std::u32string& namespaceUri_);
+    std::u32string prefix;
+    bool bound;
+    std::u32string namespaceUri;
+};
+
+struct SNGXML_XML_API ElementScope
+{
+    std::u32string qualifiedName;
+    std::vector<NamespaceBinding> previousBindings;
+};
+
+//  ====================================================================================
+//  Non-validating XML parser that decodes UTF-8 input as it goes and drives the content
+//  handler directly. Input is read either from a memory range, for example a mapped
+//  file, or from a stream in fixed size chunks, so the document is never held as a
+//  UTF-32 string. Only the names, values and text handed out to the content handler
+//  are converted to UTF-32. Elements are parsed without recursion.
+//  ====================================================================================
+
+class SNGXML_XML_API XmlStreamParser
+{
+public:
+    XmlStreamParser(const char* begin_, const char* end_, const std::string& systemId_, XmlContentHandler* contentHandler_);
+    XmlStreamParser(soulng::util::Stream& stream_, const std::string& systemId_, XmlContentHandler* contentHandler_);
+    XmlStreamParser(const XmlStreamParser&) = delete;
+    XmlStreamParser& operator=(const XmlStreamParser&) = delete;
+    void Parse();
+private:
+    bool Fill(int64_t count);
+    bool AtEnd();
+    bool StartsWith(const char* s);
+    char32_t PeekChar(int& length);
+    char32_t GetChar();
+    void Advance(int length, char32_t c);
+    void AdvanceRun(const char* runEnd);
+    void Skip(const char* s);
+    bool SkipSpace();
+    void Expect(const char* s);
+    std::u32string ParseName();
+    void ParseQuoted(std::u32string& value);
+    void ParseXmlDecl();
+    void ParseMisc(bool prolog);
+    void ParseDocTypeDecl();
+    void ParseComment();
+    void ParsePI();
+    void ParseCDataSection();
+    void ParseElement();
+    void ParseStartTag();
+    void ParseEndTag();
+    void EndElement();
+    void ParseCharData();
+    void ParseAttributeValue(std::u32string& value);
+    void ParseReference(std::u32string* attributeValue);
+    void Bind(const std::u32string& prefix, const std::u32string& namespaceUri, ElementScope& scope);
+    std::u32string GetNamespaceUri(const std::u32string& prefix);
+    void ParseQualifiedName(const std::u32string& qualifiedName, std::u32string& localName, std::u32string& prefix);
+    [[noreturn]] void Error(const std::string& message);
+    soulng::util::Stream* stream;
+    std::vector<char> buffer;
+    const char* pos;
+    const char* end;
+    std::string systemId;
+    XmlContentHandler* contentHandler;
+    int line;
+    int col;
+    std::vector<ElementScope> elementStack;
+    std::unordered_map<std::u32string, std::u32string> namespaceUris;
+    Attributes attributes;
+    std::u32string text;
+};
+
+} } // namespace sngxml::xml
+
+#endif // SNGXML_XML_XML_STREAM_PARSER
@@ -0,0 +1,134 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xml/XmlWriter.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace sngxml { namespace xml {
+
+const size_t xmlWriterBufferSize = 64 * 1024;
+
+XmlWriter::XmlWriter(std::ostream& stream_, int indentSize_) : stream(stream_), indentSize(indentSize_), startTagOpen(false)
+{
+    buffer.reserve(xmlWriterBufferSize + 4096);
+}
+
+XmlWriter::~XmlWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (...)
+    {
+    }
+}
+
+void XmlWriter::StartElement(const std::string& name)
+{
+    if (startTagOpen)
+    {
+        CloseStartTag(false);
+    }
+    Indent();
+    buffer.append(1, '<').append(name);
+    elementNames.push_back(name);
+    startTagOpen = true;
+}
+
+// Attributes are collected until the start tag is closed, so that they can be written in name order like the DOM writes them.
+// Names are compared byte by byte, which orders UTF-8 encoded names by code point.
+
+void XmlWriter::Attribute(const std::string& name, const std::string& value)
+{
+    if (!startTagOpen)
+    {
+        throw std::runtime_error("XmlWriter: attribute '" + name + "' written outside start tag");
+    }
+    attributes.push_back(std::make_pair(name, value));
+}
+
+void XmlWriter::EndElement()
+{
+    if (elementNames.empty())
+    {
+        throw std::runtime_error("XmlWriter: no open element");
+    }
+    if (startTagOpen)
+    {
+        CloseStartTag(true);
+    }
+    else
+    {
+        std::string name = std::move(elementNames.back());
+        elementNames.pop_back();
+        Indent();
+        buffer.append("</").append(name).append(">\n");
+    }
+    if (buffer.length() >= xmlWriterBufferSize)
+    {
+        Flush();
+    }
+}
+
+void XmlWriter::Flush()
+{
+    stream.write(buffer.data(), buffer.length());
+    buffer.clear();
+    stream.flush();
+}
+
+void XmlWriter::CloseStartTag(bool empty)
+{
+    std::stable_sort(attributes.begin(), attributes.end(), [](const std::pair<std::string, std::string>& left, const std::pair<std::string, std::string>& right) { return left.first < right.first; });
+    for (const auto& attribute : attributes)
+    {
+        buffer.append(1, ' ').append(attribute.first).append(1, '=');
+        AppendAttributeValue(attribute.second);
+    }
+    attributes.clear();
+    if (empty)
+    {
+        buffer.append("/>\n");
+        elementNames.pop_back();
+    }
+    else
+    {
+        buffer.append(">\n");
+    }
+    startTagOpen = false;
+}
+
+void XmlWriter::Indent()
+{
+    buffer.append(elementNames.size() * indentSize, ' ');
+}
+
+// The value is delimited by double quotes unless it contains a double quote but no single quote.
+
+void XmlWriter::AppendAttributeValue(const std::string& value)
+{
+    char delimiter = '"';
+    if (value.find('"') != std::string::npos && value.find('\'') == std::string::npos)
+    {
+        delimiter = '\'';
+    }
+    buffer.append(1, delimiter);
+    for (char c : value)
+    {
+        switch (c)
+        {
+            case '<': buffer.append("&lt;"); break;
+            case '&': buffer.append("&amp;"); break;
+            case '"': if (delimiter == '"') buffer.append("&quot;"); else buffer.append(1, c); break;
+            case '\'': if (delimiter == '\'') buffer.append("&apos;"); else buffer.append(1, c); break;
+            default: buffer.append(1, c); break;
+        }
+    }
+    buffer.append(1, delimiter);
+}
+
+} } // namespace sngxml::xml
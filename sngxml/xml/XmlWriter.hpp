@@ -0,0 +1,49 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_XML_XML_WRITER
+#define SNGXML_XML_XML_WRITER
+#include <sngxml/xml/XmlApi.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sngxml { namespace xml {
+
+//  =====================================================================================
+//  Writes an XML document of elements and attributes to a stream as the elements are
+//  emitted, without building a DOM tree. The output is the same as writing the
+//  corresponding sngxml::dom document with a CodeFormatter: attributes in name order,
+//  an element without children as an empty-element tag, each tag on its own line and
+//  children indented by the indent size. Output is collected into a buffer that is
+//  written to the stream when it fills up and when the writer is flushed or destroyed.
+//  =====================================================================================
+
+class SNGXML_XML_API XmlWriter
+{
+public:
+    XmlWriter(std::ostream& stream_, int indentSize_);
+    XmlWriter(const XmlWriter&) = delete;
+    XmlWriter& operator=(const XmlWriter&) = delete;
+    ~XmlWriter();
+    void StartElement(const std::string& name);
+    void Attribute(const std::string& name, const std::string& value);
+    void EndElement();
+    void Flush();
+private:
+    void CloseStartTag(bool empty);
+    void Indent();
+    void AppendAttributeValue(const std::string& value);
+    std::ostream& stream;
+    int indentSize;
+    std::string buffer;
+    std::vector<std::string> elementNames;
+    bool startTagOpen;
+    std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+} } // namespace sngxml::xml
+
+#endif // SNGXML_XML_XML_WRITER
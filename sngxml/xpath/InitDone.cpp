@@ -5,6 +5,7 @@
 
 #include <sngxml/xpath/InitDone.hpp>
 #include <sngxml/xpath/XPathFunction.hpp>
+#include <sngxml/xpath/XPathCompiled.hpp>
 #include <sngxml/xpath/XPathDebug.hpp>
 
 namespace sngxml { namespace xpath {
@@ -13,10 +14,12 @@ void Init()
 {
     InitFunction();
     InitDebug();
+    InitCompiled();
 }
 
 void Done()
 {
+    DoneCompiled();
     DoneDebug();
     DoneFunction();
 }
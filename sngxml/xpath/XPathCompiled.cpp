@@ -0,0 +1,202 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xpath/XPathCompiled.hpp>
+#include <sngxml/xpath/XPathParser.hpp>
+#include <sngxml/xpath/XPathLexer.hpp>
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace sngxml { namespace xpath {
+
+const int defaultXPathCacheCapacity = 256;
+
+CompiledXPath::CompiledXPath(const std::u32string& expression_, std::unique_ptr<XPathExpr>&& expr_) : expression(expression_), expr(std::move(expr_)), simple(false)
+{
+    simple = expr->LowerTo(simplePath);
+    if (!simple)
+    {
+        simplePath = XPathSimplePath();
+    }
+}
+
+std::unique_ptr<XPathObject> CompiledXPath::Evaluate(sngxml::dom::Node* node) const
+{
+    if (simple)
+    {
+        std::vector<sngxml::dom::Node*> nodes;
+        SelectSimplePath(simplePath, node, nodes);
+        std::unique_ptr<XPathNodeSet> nodeSet(new XPathNodeSet());
+        for (sngxml::dom::Node* selectedNode : nodes)
+        {
+            nodeSet->AddUnique(selectedNode);
+        }
+        return std::unique_ptr<XPathObject>(nodeSet.release());
+    }
+    XPathContext context(node, 1, 1);
+    return expr->Evaluate(context);
+}
+
+std::vector<sngxml::dom::Node*> CompiledXPath::Select(sngxml::dom::Node* node) const
+{
+    std::vector<sngxml::dom::Node*> nodes;
+    if (simple)
+    {
+        SelectSimplePath(simplePath, node, nodes);
+    }
+    else
+    {
+        std::unique_ptr<XPathObject> result = Evaluate(node);
+        if (result && result->Type() == XPathObjectType::nodeSet)
+        {
+            XPathNodeSet* nodeSet = static_cast<XPathNodeSet*>(result.get());
+            int n = nodeSet->Length();
+            for (int i = 0; i < n; ++i)
+            {
+                nodes.push_back((*nodeSet)[i]);
+            }
+        }
+    }
+    return nodes;
+}
+
+std::shared_ptr<CompiledXPath> Compile(const std::u32string& xpathExpression)
+{
+    XPathLexer xpathLexer(xpathExpression, "", 0);
+    std::unique_ptr<XPathExpr> xpathExpr(XPathParser::Parse(xpathLexer));
+    return std::shared_ptr<CompiledXPath>(new CompiledXPath(xpathExpression, std::move(xpathExpr)));
+}
+
+class XPathCache
+{
+public:
+    static void Init();
+    static void Done();
+    static XPathCache& Instance();
+    std::shared_ptr<CompiledXPath> Get(const std::u32string& xpathExpression);
+    void SetCapacity(int capacity_);
+    int Capacity();
+    void Clear();
+private:
+    static std::unique_ptr<XPathCache> instance;
+    XPathCache();
+    void Trim();
+    std::mutex mtx;
+    int capacity;
+    std::list<std::shared_ptr<CompiledXPath>> lru;
+    std::unordered_map<std::u32string, std::list<std::shared_ptr<CompiledXPath>>::iterator> map;
+};
+
+std::unique_ptr<XPathCache> XPathCache::instance;
+
+XPathCache::XPathCache() : capacity(defaultXPathCacheCapacity)
+{
+}
+
+void XPathCache::Init()
+{
+    instance.reset(new XPathCache());
+}
+
+void XPathCache::Done()
+{
+    instance.reset();
+}
+
+XPathCache& XPathCache::Instance()
+{
+    return *instance;
+}
+
+// The expression is parsed without holding the lock, so a slow or failing parse does not block the other threads.
+// If two threads parse the same expression at the same time, the one that finishes first wins.
+
+std::shared_ptr<CompiledXPath> XPathCache::Get(const std::u32string& xpathExpression)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = map.find(xpathExpression);
+        if (it != map.cend())
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            return *it->second;
+        }
+    }
+    std::shared_ptr<CompiledXPath> compiled = Compile(xpathExpression);
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = map.find(xpathExpression);
+    if (it != map.cend())
+    {
+        lru.splice(lru.begin(), lru, it->second);
+        return *it->second;
+    }
+    lru.push_front(compiled);
+    map[xpathExpression] = lru.begin();
+    Trim();
+    return compiled;
+}
+
+void XPathCache::SetCapacity(int capacity_)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    capacity = std::max(0, capacity_);
+    Trim();
+}
+
+int XPathCache::Capacity()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return capacity;
+}
+
+void XPathCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    map.clear();
+    lru.clear();
+}
+
+void XPathCache::Trim()
+{
+    while (static_cast<int>(lru.size()) > capacity)
+    {
+        map.erase(lru.back()->Expression());
+        lru.pop_back();
+    }
+}
+
+std::shared_ptr<CompiledXPath> GetCompiledXPath(const std::u32string& xpathExpression)
+{
+    return XPathCache::Instance().Get(xpathExpression);
+}
+
+void SetXPathCacheCapacity(int capacity)
+{
+    XPathCache::Instance().SetCapacity(capacity);
+}
+
+int XPathCacheCapacity()
+{
+    return XPathCache::Instance().Capacity();
+}
+
+void ClearXPathCache()
+{
+    XPathCache::Instance().Clear();
+}
+
+void InitCompiled()
+{
+    XPathCache::Init();
+}
+
+void DoneCompiled()
+{
+    XPathCache::Done();
+}
+
+} } // namespace sngxml::xpath
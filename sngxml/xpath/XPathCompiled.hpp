@@ -0,0 +1,49 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_XPATH_XPATH_COMPILED
+#define SNGXML_XPATH_XPATH_COMPILED
+#include <sngxml/xpath/XPathExpr.hpp>
+
+namespace sngxml { namespace xpath {
+
+// A parsed XPath expression that can be evaluated any number of times against any node.
+// The expression tree is not modified by evaluation, so the same compiled expression can be evaluated by several threads at once.
+// A location path that can be lowered to a simple path is selected by walking the document directly instead of evaluating the expression tree.
+// Select returns the selected nodes without creating an XPath object.
+
+class SNGXML_XPATH_API CompiledXPath
+{
+public:
+    CompiledXPath(const std::u32string& expression_, std::unique_ptr<XPathExpr>&& expr_);
+    CompiledXPath(const CompiledXPath&) = delete;
+    CompiledXPath& operator=(const CompiledXPath&) = delete;
+    const std::u32string& Expression() const { return expression; }
+    XPathExpr* Expr() const { return expr.get(); }
+    bool IsSimplePath() const { return simple; }
+    std::unique_ptr<XPathObject> Evaluate(sngxml::dom::Node* node) const;
+    std::vector<sngxml::dom::Node*> Select(sngxml::dom::Node* node) const;
+private:
+    std::u32string expression;
+    std::unique_ptr<XPathExpr> expr;
+    bool simple;
+    XPathSimplePath simplePath;
+};
+
+// Parses the expression every time it is called.
+SNGXML_XPATH_API std::shared_ptr<CompiledXPath> Compile(const std::u32string& xpathExpression);
+
+// Returns the compiled expression from the expression cache, parsing and adding it first if it is not there.
+// The cache keeps the most recently used expressions; the least recently used one is dropped when the cache is full.
+SNGXML_XPATH_API std::shared_ptr<CompiledXPath> GetCompiledXPath(const std::u32string& xpathExpression);
+SNGXML_XPATH_API void SetXPathCacheCapacity(int capacity);
+SNGXML_XPATH_API int XPathCacheCapacity();
+SNGXML_XPATH_API void ClearXPathCache();
+SNGXML_XPATH_API void InitCompiled();
+SNGXML_XPATH_API void DoneCompiled();
+
+} } // namespace sngxml::xpath
+
+#endif // SNGXML_XPATH_XPATH_COMPILED
@@ -15,26 +15,34 @@
 
 namespace sngxml { namespace xpath {
 
-std::unique_ptr<XPathObject> Evaluate(const std::u32string& xpathExpression, sngxml::dom::Node* node)
+// When parsing is being debugged the expression is always parsed so that the parsing log is written, and when queries are being debugged
+// the parsing and evaluation are timed. Otherwise the expression comes from the expression cache and the clock is not read at all.
+
+std::unique_ptr<XPathObject> EvaluateDebug(const std::u32string& xpathExpression, sngxml::dom::Node* node)
 {
     soulng::lexer::XmlParsingLog debugLog(std::cerr);
     std::chrono::time_point<std::chrono::steady_clock> startQuery = std::chrono::steady_clock::now();
-    XPathLexer xpathLexer(xpathExpression, "", 0);
+    std::shared_ptr<CompiledXPath> compiled;
     if (XPathDebugParsing())
     {
+        XPathLexer xpathLexer(xpathExpression, "", 0);
         xpathLexer.SetLog(&debugLog);
+        std::unique_ptr<XPathExpr> xpathExpr(XPathParser::Parse(xpathLexer));
+        compiled.reset(new CompiledXPath(xpathExpression, std::move(xpathExpr)));
+    }
+    else
+    {
+        compiled = GetCompiledXPath(xpathExpression);
     }
-    std::unique_ptr<XPathExpr> xpathExpr(XPathParser::Parse(xpathLexer));
     std::chrono::time_point<std::chrono::steady_clock> endQuery = std::chrono::steady_clock::now();
     if (XPathDebugQuery())
     {
-        std::unique_ptr<dom::Node> queryDom = xpathExpr->ToDom();
+        std::unique_ptr<dom::Node> queryDom = compiled->Expr()->ToDom();
         SetXPathQueryDom(std::move(queryDom));
         SetXPathQueryDuration(std::chrono::nanoseconds(endQuery - startQuery));
     }
     std::chrono::time_point<std::chrono::steady_clock> startEvaluate = std::chrono::steady_clock::now();
-    XPathContext context(node, 1, 1);
-    std::unique_ptr<XPathObject> result = xpathExpr->Evaluate(context);
+    std::unique_ptr<XPathObject> result = compiled->Evaluate(node);
     std::chrono::time_point<std::chrono::steady_clock> endEvaluate = std::chrono::steady_clock::now();
     if (XPathDebugQuery())
     {
@@ -43,6 +51,15 @@ std::unique_ptr<XPathObject> Evaluate(const std::u32string& xpathExpression, sng
     return result;
 }
 
+std::unique_ptr<XPathObject> Evaluate(const std::u32string& xpathExpression, sngxml::dom::Node* node)
+{
+    if (XPathDebugParsing() || XPathDebugQuery())
+    {
+        return EvaluateDebug(xpathExpression, node);
+    }
+    return GetCompiledXPath(xpathExpression)->Evaluate(node);
+}
+
 std::unique_ptr<XPathObject> Evaluate(const std::u32string& xpathExpression, sngxml::dom::Document* document)
 {
     return Evaluate(xpathExpression, static_cast<sngxml::dom::Node*>(document));
@@ -5,7 +5,7 @@
 
 #ifndef SNGXML_XPATH_XPATH_EVALUATE
 #define SNGXML_XPATH_XPATH_EVALUATE
-#include <sngxml/xpath/XPathObject.hpp>
+#include <sngxml/xpath/XPathCompiled.hpp>
 
 namespace sngxml { namespace xpath {
 
@@ -1194,6 +1194,13 @@ std::unique_ptr<dom::Node> XPathCombineStepExpr::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+// Combining steps is associative with respect to both the selected nodes and their order, so nested combinations can be flattened into a single list of steps.
+
+bool XPathCombineStepExpr::LowerTo(XPathSimplePath& path) const
+{
+    return Left()->LowerTo(path) && Right()->LowerTo(path);
+}
+
 XPathRootNodeExpr::XPathRootNodeExpr()
 {
 }
@@ -1218,6 +1225,13 @@ std::unique_ptr<dom::Node> XPathRootNodeExpr::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+bool XPathRootNodeExpr::LowerTo(XPathSimplePath& path) const
+{
+    if (path.absolute || !path.steps.empty()) return false;
+    path.absolute = true;
+    return true;
+}
+
 XPathFilterExpr::XPathFilterExpr(XPathExpr* expr_, XPathExpr* predicate_) : XPathUnaryExpr(expr_), predicate(predicate_)
 {
 }
@@ -1256,7 +1270,7 @@ std::unique_ptr<XPathObject> XPathFilterExpr::Evaluate(XPathContext& context)
         }
         if (booleanResult)
         {
-            filteredNodeSet->Add(node);
+            filteredNodeSet->AddUnique(node);
         }
     }
     std::swap(nodeSet, filteredNodeSet);
@@ -1292,7 +1306,7 @@ void NodeSelectionOp::Apply(sngxml::dom::Node* node)
 {
     if (nodeTest->Select(node, axis))
     {
-        nodeSet.Add(node);
+        nodeSet.AddUnique(node);
     }
 }
 
@@ -1338,7 +1352,7 @@ std::unique_ptr<XPathObject> XPathLocationStepExpr::Evaluate(XPathContext& conte
             }
             if (booleanResult)
             {
-                filteredNodeSet->Add(node);
+                filteredNodeSet->AddUnique(node);
             }
         }
         std::swap(nodeSet, filteredNodeSet);
@@ -1365,6 +1379,17 @@ std::unique_ptr<dom::Node> XPathLocationStepExpr::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+bool XPathLocationStepExpr::LowerTo(XPathSimplePath& path) const
+{
+    if (!predicates.empty()) return false;
+    if (axis != sngxml::dom::Axis::child && axis != sngxml::dom::Axis::descendant && axis != sngxml::dom::Axis::descendantOrSelf) return false;
+    XPathSimpleStep step;
+    step.axis = axis;
+    if (!nodeTest->LowerTo(step)) return false;
+    path.steps.push_back(step);
+    return true;
+}
+
 class AxisMap
 {
 public:
@@ -1490,6 +1515,12 @@ std::unique_ptr<dom::Node> XPathPrincipalNodeTest::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+bool XPathPrincipalNodeTest::LowerTo(XPathSimpleStep& step) const
+{
+    step.testKind = XPathSimpleTestKind::element;
+    return true;
+}
+
 bool XPathAnyNodeTest::Select(sngxml::dom::Node* node, sngxml::dom::Axis axis) const
 {
     return true;
@@ -1501,6 +1532,12 @@ std::unique_ptr<dom::Node> XPathAnyNodeTest::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+bool XPathAnyNodeTest::LowerTo(XPathSimpleStep& step) const
+{
+    step.testKind = XPathSimpleTestKind::anyNode;
+    return true;
+}
+
 XPathPrefixTest::XPathPrefixTest(const std::u32string& name_) : name(name_)
 {
 }
@@ -1579,6 +1616,13 @@ std::unique_ptr<dom::Node> XPathNameTest::ToDom() const
     return std::unique_ptr<dom::Node>(element.release());
 }
 
+bool XPathNameTest::LowerTo(XPathSimpleStep& step) const
+{
+    step.testKind = XPathSimpleTestKind::name;
+    step.name = name;
+    return true;
+}
+
 XPathVariableReference::XPathVariableReference(const std::u32string& name_) : name(name_)
 {
 }
@@ -7,6 +7,7 @@
 #define SNGXML_XPATH_XPATH_EXPR
 #include <sngxml/xpath/XPathObject.hpp>
 #include <sngxml/xpath/XPathContext.hpp>
+#include <sngxml/xpath/XPathSimplePath.hpp>
 #include <string>
 #include <memory>
 #include <vector>
@@ -30,6 +31,7 @@ public:
     virtual std::unique_ptr<XPathObject> Evaluate(XPathContext& context) { return std::unique_ptr<XPathObject>(); }
     virtual std::u32string TextValue() const { return std::u32string(); }
     virtual std::unique_ptr<dom::Node> ToDom() const = 0;
+    virtual bool LowerTo(XPathSimplePath& path) const { return false; }
 };
 
 class SNGXML_XPATH_API XPathUnaryExpr : public XPathExpr
@@ -178,6 +180,7 @@ public:
     XPathCombineStepExpr(XPathExpr* left_, XPathExpr* right_);
     std::unique_ptr<XPathObject> Evaluate(XPathContext& context) override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimplePath& path) const override;
 };
 
 class SNGXML_XPATH_API XPathRootNodeExpr : public XPathExpr
@@ -186,6 +189,7 @@ public:
     XPathRootNodeExpr();
     std::unique_ptr<XPathObject> Evaluate(XPathContext& context) override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimplePath& path) const override;
 };
 
 class SNGXML_XPATH_API XPathFilterExpr : public XPathUnaryExpr
@@ -202,6 +206,7 @@ class SNGXML_XPATH_API XPathNodeTestExpr : public XPathExpr
 {
 public:
     virtual bool Select(sngxml::dom::Node* node, sngxml::dom::Axis axis) const { return true; }
+    virtual bool LowerTo(XPathSimpleStep& step) const { return false; }
 };
 
 class SNGXML_XPATH_API XPathLocationStepExpr : public XPathExpr
@@ -215,6 +220,7 @@ public:
     void AddPredicate(XPathExpr* predicate);
     std::unique_ptr<XPathObject> Evaluate(XPathContext& context) override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimplePath& path) const override;
 private:
     sngxml::dom::Axis axis;
     std::unique_ptr<XPathNodeTestExpr> nodeTest;
@@ -259,6 +265,7 @@ class SNGXML_XPATH_API XPathAnyNodeTest : public XPathNodeTestExpr
 public:
     bool Select(sngxml::dom::Node* node, sngxml::dom::Axis axis) const override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimpleStep& step) const override;
 };
 
 class SNGXML_XPATH_API XPathPrincipalNodeTest : public XPathNodeTestExpr
@@ -266,6 +273,7 @@ class SNGXML_XPATH_API XPathPrincipalNodeTest : public XPathNodeTestExpr
 public:
     bool Select(sngxml::dom::Node* node, sngxml::dom::Axis axis) const override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimpleStep& step) const override;
 };
 
 class SNGXML_XPATH_API XPathPrefixTest : public XPathNodeTestExpr
@@ -284,6 +292,7 @@ public:
     XPathNameTest(const std::u32string& name_);
     bool Select(sngxml::dom::Node* node, sngxml::dom::Axis axis) const override;
     std::unique_ptr<dom::Node> ToDom() const override;
+    bool LowerTo(XPathSimpleStep& step) const override;
 private:
     std::u32string name;
 };
@@ -38,7 +38,7 @@ std::u32string StringValue(sngxml::dom::Node* node)
     }
     case sngxml::dom::NodeType::attributeNode:
     {
-        sngxml::dom::Attr* attr = static_cast<sngxml::dom::Attr*>(node);
+        const sngxml::dom::Attr* attr = static_cast<const sngxml::dom::Attr*>(node);
         return attr->Value();
     }
     case sngxml::dom::NodeType::processingInstructionNode:
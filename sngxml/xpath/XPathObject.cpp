@@ -23,9 +23,46 @@ XPathNodeSet::XPathNodeSet() : XPathObject(XPathObjectType::nodeSet)
 {
 }
 
+const int nodeSetIndexThreshold = 16;
+
+// Nodes are kept in the order they were added. Small sets are searched linearly; when a set grows past the threshold, its nodes are
+// entered into a hash index, so that adding a node takes constant time and building a large set takes linear time.
+
 void XPathNodeSet::Add(sngxml::dom::Node* node)
 {
-    nodes.InternalAddNode(node);
+    if (index.empty())
+    {
+        int n = nodes.Length();
+        if (n < nodeSetIndexThreshold)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                if (nodes[i] == node) return;
+            }
+            nodes.InternalAppendNode(node);
+            return;
+        }
+        index.reserve(2 * n);
+        for (int i = 0; i < n; ++i)
+        {
+            index.insert(nodes[i]);
+        }
+    }
+    if (index.insert(node).second)
+    {
+        nodes.InternalAppendNode(node);
+    }
+}
+
+// Adds a node that the caller knows is not yet in the set, for example a node produced by walking an axis or a node that passed a predicate.
+
+void XPathNodeSet::AddUnique(sngxml::dom::Node* node)
+{
+    nodes.InternalAppendNode(node);
+    if (!index.empty())
+    {
+        index.insert(node);
+    }
 }
 
 std::unique_ptr<dom::Node> XPathNodeSet::ToDom() const
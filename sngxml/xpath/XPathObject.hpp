@@ -7,6 +7,7 @@
 #define SNGXML_XPATH_XPATH_OBJECT
 #include <sngxml/xpath/XPathApi.hpp>
 #include <sngxml/dom/Node.hpp>
+#include <unordered_set>
 
 namespace sngxml { namespace xpath {
 
@@ -33,9 +34,11 @@ public:
     sngxml::dom::Node* operator[](int index) const { return nodes[index]; }
     int Length() const { return nodes.Length(); }
     void Add(sngxml::dom::Node* node);
+    void AddUnique(sngxml::dom::Node* node);
     std::unique_ptr<dom::Node> ToDom() const override;
 private:
     sngxml::dom::NodeList nodes;
+    std::unordered_set<sngxml::dom::Node*> index;
 };
 
 class SNGXML_XPATH_API XPathBoolean : public XPathObject
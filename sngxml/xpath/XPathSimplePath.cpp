@@ -0,0 +1,183 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xpath/XPathSimplePath.hpp>
+#include <sngxml/dom/Document.hpp>
+#include <unordered_set>
+
+namespace sngxml { namespace xpath {
+
+XPathSimpleStep::XPathSimpleStep() : axis(sngxml::dom::Axis::child), testKind(XPathSimpleTestKind::anyNode)
+{
+}
+
+XPathSimplePath::XPathSimplePath() : absolute(false)
+{
+}
+
+bool IsParentNode(sngxml::dom::Node* node)
+{
+    switch (node->GetNodeType())
+    {
+        case sngxml::dom::NodeType::documentNode:
+        case sngxml::dom::NodeType::documentFragmentNode:
+        case sngxml::dom::NodeType::elementNode:
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+sngxml::dom::Node* FirstChildOf(sngxml::dom::Node* node)
+{
+    if (IsParentNode(node))
+    {
+        return static_cast<sngxml::dom::ParentNode*>(node)->FirstChild();
+    }
+    return nullptr;
+}
+
+// Next node in document order within the subtree of root, or null when the subtree has been walked.
+
+sngxml::dom::Node* NextInSubtree(sngxml::dom::Node* node, sngxml::dom::Node* root)
+{
+    sngxml::dom::Node* firstChild = FirstChildOf(node);
+    if (firstChild)
+    {
+        return firstChild;
+    }
+    while (node != root)
+    {
+        if (node->NextSibling())
+        {
+            return node->NextSibling();
+        }
+        node = node->Parent();
+    }
+    return nullptr;
+}
+
+bool SimpleStepMatches(const XPathSimpleStep& step, sngxml::dom::Node* node)
+{
+    switch (step.testKind)
+    {
+        case XPathSimpleTestKind::name:
+        {
+            return node->GetNodeType() == sngxml::dom::NodeType::elementNode && node->Name() == step.name;
+        }
+        case XPathSimpleTestKind::element:
+        {
+            return node->GetNodeType() == sngxml::dom::NodeType::elementNode;
+        }
+    }
+    return true;
+}
+
+class SimplePathSelector
+{
+public:
+    SimplePathSelector(std::vector<sngxml::dom::Node*>& result_, bool distinct_);
+    void Add(sngxml::dom::Node* node);
+    void SelectChildren(const XPathSimpleStep& step, sngxml::dom::Node* parent);
+private:
+    std::vector<sngxml::dom::Node*>& result;
+    bool distinct;
+    std::unordered_set<sngxml::dom::Node*> index;
+};
+
+SimplePathSelector::SimplePathSelector(std::vector<sngxml::dom::Node*>& result_, bool distinct_) : result(result_), distinct(distinct_)
+{
+}
+
+void SimplePathSelector::Add(sngxml::dom::Node* node)
+{
+    if (distinct || index.insert(node).second)
+    {
+        result.push_back(node);
+    }
+}
+
+void SimplePathSelector::SelectChildren(const XPathSimpleStep& step, sngxml::dom::Node* parent)
+{
+    for (sngxml::dom::Node* child = FirstChildOf(parent); child; child = child->NextSibling())
+    {
+        if (SimpleStepMatches(step, child))
+        {
+            Add(child);
+        }
+    }
+}
+
+// Children of distinct nodes are distinct, so a child step never produces duplicates. The subtrees walked by a descendant step may be nested if the previous
+// step produced both a node and its descendant, so then duplicates are removed. A descendant-or-self::node() step followed by a child step, the expansion of
+// '//', is evaluated in one walk: the children of each node of the subtree are selected as the node is visited.
+
+void SelectSimplePath(const XPathSimplePath& path, sngxml::dom::Node* node, std::vector<sngxml::dom::Node*>& nodes)
+{
+    std::vector<sngxml::dom::Node*> current;
+    if (path.absolute && node->GetNodeType() != sngxml::dom::NodeType::documentNode)
+    {
+        node = node->OwnerDocument();
+    }
+    if (node)
+    {
+        current.push_back(node);
+    }
+    int n = path.steps.size();
+    for (int i = 0; i < n; ++i)
+    {
+        const XPathSimpleStep& step = path.steps[i];
+        std::vector<sngxml::dom::Node*> next;
+        switch (step.axis)
+        {
+            case sngxml::dom::Axis::child:
+            {
+                SimplePathSelector selector(next, true);
+                for (sngxml::dom::Node* parent : current)
+                {
+                    selector.SelectChildren(step, parent);
+                }
+                break;
+            }
+            case sngxml::dom::Axis::descendant:
+            case sngxml::dom::Axis::descendantOrSelf:
+            {
+                SimplePathSelector selector(next, current.size() == 1);
+                bool selectChildren = step.axis == sngxml::dom::Axis::descendantOrSelf && step.testKind == XPathSimpleTestKind::anyNode &&
+                    i + 1 < n && path.steps[i + 1].axis == sngxml::dom::Axis::child;
+                for (sngxml::dom::Node* root : current)
+                {
+                    sngxml::dom::Node* descendant = root;
+                    if (step.axis == sngxml::dom::Axis::descendant)
+                    {
+                        descendant = FirstChildOf(root);
+                    }
+                    while (descendant)
+                    {
+                        if (selectChildren)
+                        {
+                            selector.SelectChildren(path.steps[i + 1], descendant);
+                        }
+                        else if (SimpleStepMatches(step, descendant))
+                        {
+                            selector.Add(descendant);
+                        }
+                        descendant = NextInSubtree(descendant, root);
+                    }
+                }
+                if (selectChildren)
+                {
+                    ++i;
+                }
+                break;
+            }
+        }
+        std::swap(current, next);
+    }
+    std::swap(nodes, current);
+}
+
+} } // namespace sngxml::xpath
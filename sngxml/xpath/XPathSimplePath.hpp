@@ -0,0 +1,46 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SNGXML_XPATH_XPATH_SIMPLE_PATH
+#define SNGXML_XPATH_XPATH_SIMPLE_PATH
+#include <sngxml/xpath/XPathApi.hpp>
+#include <sngxml/dom/Node.hpp>
+#include <vector>
+
+namespace sngxml { namespace xpath {
+
+enum class XPathSimpleTestKind
+{
+    name, element, anyNode
+};
+
+struct SNGXML_XPATH_API XPathSimpleStep
+{
+    XPathSimpleStep();
+    sngxml::dom::Axis axis;
+    XPathSimpleTestKind testKind;
+    std::u32string name;
+};
+
+//  ===========================================================================================
+//  A location path that consists of child, descendant and descendant-or-self steps whose node
+//  tests are a name, '*' or node(), and that has no predicates. Such a path is lowered from
+//  the parsed expression and selected by walking the sibling lists directly, without building
+//  an XPath object for each step. The nodes come out in the same order as from the general
+//  evaluator: for each node of the previous step, the nodes it selects, without duplicates.
+//  ===========================================================================================
+
+struct SNGXML_XPATH_API XPathSimplePath
+{
+    XPathSimplePath();
+    bool absolute;
+    std::vector<XPathSimpleStep> steps;
+};
+
+SNGXML_XPATH_API void SelectSimplePath(const XPathSimplePath& path, sngxml::dom::Node* node, std::vector<sngxml::dom::Node*>& nodes);
+
+} } // namespace sngxml::xpath
+
+#endif // SNGXML_XPATH_XPATH_SIMPLE_PATH
@@ -8,12 +8,13 @@
 #include <soulng/util/Unicode.hpp>
 #include <string>
 #include <algorithm>
+#include <cassert>
 
 namespace soulng { namespace lexer {
 
 using namespace soulng::unicode;
 
-LexerState::LexerState() : token(), line(0), lexeme(), pos(), tokens(), flags(), recordedPosPair(), farthestPos(), currentPos()
+LexerState::LexerState() : token(), line(0), lexeme(), pos(), tokens(), flags(), recordedPosPair(), farthestPos(), currentPos(), windowStart()
 {
 }
 
@@ -26,14 +27,14 @@ LineMapper::~LineMapper()
 }
 
 Lexer::Lexer(const std::u32string& content_, const std::string& fileName_, int fileIndex_) :
-    content(content_), fileName(fileName_), fileIndex(fileIndex_), line(1), keywordMap(nullptr), start(content.c_str()), end(content.c_str() + content.length()), pos(start), current(tokens.end()),
+    content(content_), fileName(fileName_), fileIndex(fileIndex_), line(1), keywordMap(nullptr), start(content.c_str()), end(content.c_str() + content.length()), pos(start), current(tokens.end()), windowStart(0), windowSize(0),
     log(nullptr), countLines(true), separatorChar('\0'), flags(), commentTokenId(-1), farthestPos(GetPos()), ruleNameVecPtr(nullptr), lineMapper(nullptr), recovered(false)
 {
     CalculateLineStarts();
 }
 
 Lexer::Lexer(const char32_t* start_, const char32_t* end_, const std::string& fileName_, int fileIndex_) :
-    content(), fileName(fileName_), fileIndex(fileIndex_), line(1), keywordMap(nullptr), start(start_), end(end_), pos(start), current(tokens.end()),
+    content(), fileName(fileName_), fileIndex(fileIndex_), line(1), keywordMap(nullptr), start(start_), end(end_), pos(start), current(tokens.end()), windowStart(0), windowSize(0),
     log(nullptr), countLines(true), separatorChar('\0'), flags(), commentTokenId(-1), farthestPos(GetPos()), ruleNameVecPtr(nullptr), lineMapper(nullptr), recovered(false)
 {
     CalculateLineStarts();
@@ -68,12 +69,23 @@ void Lexer::operator++()
         }
         if (current == tokens.end())
         {
+            if (countLines && !tokens.empty() && tokens.back().id != END_TOKEN)
+            {
+                // the line may have been set back by SetPos, so lexing continues from the line where the last token ends
+                const Token& lastToken = tokens.back();
+                line = lastToken.line + static_cast<int32_t>(std::count(lastToken.match.begin, lastToken.match.end, '\n'));
+            }
             NextToken();
+            assert(!GetFlag(LexerFlags::tokenWindow) || OneTokenPerCharacter());
         }
         else
         {
             line = current->line;
         }
+        if (GetFlag(LexerFlags::tokenWindow) && current - tokens.begin() >= 2 * windowSize)
+        {
+            ReleaseTokens();
+        }
         if (GetFlag(LexerFlags::farthestError))
         {
             int64_t p = GetPos();
@@ -88,16 +100,94 @@ void Lexer::operator++()
 
 int64_t Lexer::GetPos() const
 {
-    int32_t p = static_cast<int32_t>(current - tokens.begin());
+    int32_t p = static_cast<int32_t>(windowStart + (current - tokens.begin()));
     return (static_cast<int64_t>(line) << 32) | static_cast<int64_t>(p);
 }
 
 void Lexer::SetPos(int64_t pos)
 {
-    current = tokens.begin() + static_cast<int32_t>(pos);
+    int32_t tokenIndex = static_cast<int32_t>(pos);
+    if (tokenIndex < windowStart || (GetFlag(LexerFlags::tokenWindow) && tokenIndex - windowStart >= static_cast<int64_t>(tokens.size())))
+    {
+        Relex(tokenIndex);
+    }
+    else
+    {
+        current = tokens.begin() + (tokenIndex - windowStart);
+    }
     line = static_cast<int32_t>(pos >> 32);
 }
 
+// In token window mode the lexer keeps only the most recent tokens in memory. This is meant for lexers that produce exactly one token for each character,
+// such as the trivial lexer used for XML: the token index of a position is then its character offset, so a released token can be made again from the content
+// whenever the parser backtracks to it or asks for its match. Memory use then no longer grows with the size of the input.
+
+void Lexer::SetTokenWindow(int64_t windowSize_)
+{
+    windowSize = std::max(static_cast<int64_t>(1), windowSize_);
+    SetFlag(LexerFlags::tokenWindow);
+}
+
+// Releases all but windowSize tokens before the current token. Called when the current token is 2 * windowSize tokens from the start of the window,
+// so each token is moved at most once.
+
+void Lexer::ReleaseTokens()
+{
+    int64_t count = (current - tokens.begin()) - windowSize;
+    tokens.erase(tokens.begin(), tokens.begin() + count);
+    windowStart += count;
+    current = tokens.begin() + windowSize;
+}
+
+// Starts a new window at a released token, or at a token past the relexed ones when the parser returns to a position it saved before backtracking, and lexes from it.
+// The tokens of the terminating null character and the end of the content are made by lexing the last character again, so that they get the same match and line
+// as when the content is lexed in one go.
+
+void Lexer::Relex(int64_t tokenIndex)
+{
+    int64_t lexIndex = std::max(static_cast<int64_t>(0), std::min(tokenIndex, static_cast<int64_t>(end - start) - 1));
+    tokens.clear();
+    windowStart = lexIndex;
+    pos = start + lexIndex;
+    line = LineOf(pos);
+    NextToken();
+    assert(OneTokenPerCharacter());
+    current = tokens.begin() + (tokenIndex - windowStart);
+}
+
+// Checks the token window invariant after a call to NextToken: each token made so far has exactly one character, so the number of tokens is the number of characters lexed.
+// At the end of the content the lexer makes a token for the terminating null character and an end token, neither of which has a character of its own.
+
+bool Lexer::OneTokenPerCharacter() const
+{
+    int64_t tokenCount = windowStart + static_cast<int64_t>(tokens.size());
+    if (!tokens.empty() && tokens.back().id == END_TOKEN)
+    {
+        return pos == end && tokenCount == (end - start) + 2;
+    }
+    return pos - start == tokenCount;
+}
+
+Token Lexer::MakeCharacterToken(int64_t tokenIndex) const
+{
+    const char32_t* p = start + tokenIndex;
+    if (p == end)
+    {
+        if (end == start)
+        {
+            return Token(static_cast<int>('\0'), Lexeme(end, end), LineOf(end));
+        }
+        return Token(static_cast<int>('\0'), Lexeme(end - 1, end), LineOf(end - 1));
+    }
+    return Token(static_cast<int>(*p), Lexeme(p, p + 1), LineOf(p));
+}
+
+int32_t Lexer::LineOf(const char32_t* p) const
+{
+    auto it = std::upper_bound(lineStarts.begin() + 1, lineStarts.end() - 1, p);
+    return std::max(1, static_cast<int32_t>(it - lineStarts.begin()) - 1);
+}
+
 SourcePos Lexer::GetSourcePos(int64_t pos) const
 {
     const char32_t* s = start;
@@ -280,9 +370,13 @@ void Lexer::ConvertExternal(Span& span)
 Token Lexer::GetToken(int64_t pos) const
 {
     int32_t tokenIndex = static_cast<int32_t>(pos);
-    if (tokenIndex >= 0 && tokenIndex < tokens.size())
+    if (tokenIndex >= windowStart && tokenIndex - windowStart < tokens.size())
+    {
+        return tokens[tokenIndex - windowStart];
+    }
+    else if (GetFlag(LexerFlags::tokenWindow) && tokenIndex >= 0 && tokenIndex <= end - start)
     {
-        return tokens[tokenIndex];
+        return MakeCharacterToken(tokenIndex);
     }
     else
     {
@@ -677,6 +771,7 @@ LexerState Lexer::GetState() const
     state.ruleContext = ruleContext;
     state.farthestRuleContext = farthestRuleContext;
     state.currentPos = GetPos();
+    state.windowStart = windowStart;
     return state;
 }
 
@@ -692,6 +787,7 @@ void Lexer::SetState(const LexerState& state)
     farthestPos = state.farthestPos;
     ruleContext = state.ruleContext;
     farthestRuleContext = state.farthestRuleContext;
+    windowStart = state.windowStart;
     SetPos(state.currentPos);
 }
 
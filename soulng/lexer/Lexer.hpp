@@ -20,7 +20,7 @@ namespace soulng { namespace lexer {
 
 enum class LexerFlags : int
 {
-    none = 0, synchronize = 1 << 0, synchronized = 1 << 1, synchronizedAtLeastOnce = 1 << 2, cursorSeen = 1 << 3, recordedParse = 1 << 4, farthestError = 1 << 5, gcc = 1 << 6, lcc = 1 << 7
+    none = 0, synchronize = 1 << 0, synchronized = 1 << 1, synchronizedAtLeastOnce = 1 << 2, cursorSeen = 1 << 3, recordedParse = 1 << 4, farthestError = 1 << 5, gcc = 1 << 6, lcc = 1 << 7, tokenWindow = 1 << 8
 };
 
 inline LexerFlags operator|(LexerFlags left, LexerFlags right)
@@ -61,6 +61,7 @@ struct SOULNG_LEXER_API LexerState
     std::vector<int> ruleContext;
     std::vector<int> farthestRuleContext;
     int64_t currentPos;
+    int64_t windowStart;
 };
 
 SOULNG_LEXER_API inline int GetLine(int64_t pos)
@@ -110,6 +111,7 @@ public:
     void SetTokens(const std::vector<Token>& tokens_);
     void SetLine(int line_) { line = line_; }
     void SetCountLines(bool countLines_) { countLines = countLines_; }
+    void SetTokenWindow(int64_t windowSize_);
     Token token;
     std::u32string GetMatch(const Span& span) const;
     std::u32string GetMatch(int64_t pos) const;
@@ -177,6 +179,8 @@ private:
     std::vector<const char32_t*> lineStarts;
     std::vector<Token> tokens;
     std::vector<Token>::iterator current;
+    int64_t windowStart;
+    int64_t windowSize;
     std::vector<std::exception> errors;
     std::vector<int> syncTokens;
     ParsingLog* log;
@@ -195,6 +199,11 @@ private:
     int commentTokenId;
     bool recovered;
     void NextToken();
+    void ReleaseTokens();
+    void Relex(int64_t tokenIndex);
+    bool OneTokenPerCharacter() const;
+    Token MakeCharacterToken(int64_t tokenIndex) const;
+    int32_t LineOf(const char32_t* p) const;
     void CalculateLineStarts();
 };
 
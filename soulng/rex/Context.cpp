@@ -6,6 +6,7 @@
 #include <soulng/rex/Context.hpp>
 #include <soulng/rex/Symbol.hpp>
 #include <soulng/rex/Nfa.hpp>
+#include <soulng/rex/FilePattern.hpp>
 
 namespace soulng { namespace rex {
 
@@ -72,4 +73,20 @@ Class* Context::MakeClass()
     return cls;
 }
 
+// Compiled matchers are immutable, so the same matcher can be shared by all rules with the same pattern and used concurrently.
+// Compilation adds states and symbols to the context, so it is done while holding the lock.
+
+std::shared_ptr<const FilePatternMatcher> Context::GetFilePatternMatcher(const std::u32string& filePattern)
+{
+    std::lock_guard<std::mutex> lock(filePatternMutex);
+    auto it = filePatternMatchers.find(filePattern);
+    if (it != filePatternMatchers.cend())
+    {
+        return it->second;
+    }
+    std::shared_ptr<const FilePatternMatcher> matcher(new FilePatternMatcher(*this, filePattern));
+    filePatternMatchers[filePattern] = matcher;
+    return matcher;
+}
+
 } } // namespace soulng::rex
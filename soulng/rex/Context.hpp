@@ -7,10 +7,14 @@
 #define SOULNG_REX_CONTEXT_INCLUDED
 #include <soulng/rex/Symbol.hpp>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace soulng { namespace rex {
 
 class NfaState;
+class FilePatternMatcher;
 
 class SOULNG_REX_API Context
 {
@@ -23,6 +27,7 @@ public:
     Symbol* MakeAny() { return &any; }
     Symbol* MakeEpsilon() { return &epsilon; }
     Class* MakeClass();
+    std::shared_ptr<const FilePatternMatcher> GetFilePatternMatcher(const std::u32string& filePattern);
 private:
     std::vector<NfaState*> nfaStates;
     std::vector<Symbol*> symbols;
@@ -30,6 +35,8 @@ private:
     Char epsilon;
     std::map<char32_t, Symbol*> charSymbols;
     std::map<Range, Symbol*> rangeSymbols;
+    std::mutex filePatternMutex;
+    std::unordered_map<std::u32string, std::shared_ptr<const FilePatternMatcher>> filePatternMatchers;
 };
 
 } } // namespace soulng::rex
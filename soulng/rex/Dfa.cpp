@@ -0,0 +1,281 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <soulng/rex/Dfa.hpp>
+#include <soulng/rex/Nfa.hpp>
+#include <soulng/rex/Symbol.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace soulng { namespace rex {
+
+DfaRange::DfaRange(char32_t start_, char32_t end_, int next_) : start(start_), end(end_), next(next_)
+{
+}
+
+Dfa::Dfa()
+{
+}
+
+int Dfa::AddState(int acceptValue)
+{
+    int state = acceptValues.size();
+    acceptValues.push_back(acceptValue);
+    asciiNext.resize(asciiNext.size() + dfaAsciiSize, dfaDeadState);
+    ranges.push_back(std::vector<DfaRange>());
+    return state;
+}
+
+void Dfa::SetNext(int state, char32_t c, int next)
+{
+    asciiNext[state * dfaAsciiSize + c] = next;
+}
+
+void Dfa::AddRange(int state, char32_t start, char32_t end, int next)
+{
+    std::vector<DfaRange>& stateRanges = ranges[state];
+    if (!stateRanges.empty() && stateRanges.back().next == next && stateRanges.back().end + 1 == start)
+    {
+        stateRanges.back().end = end;
+    }
+    else
+    {
+        stateRanges.push_back(DfaRange(start, end, next));
+    }
+}
+
+int Dfa::Next(int state, char32_t c) const
+{
+    if (c < dfaAsciiSize)
+    {
+        return asciiNext[state * dfaAsciiSize + c];
+    }
+    const std::vector<DfaRange>& stateRanges = ranges[state];
+    auto it = std::upper_bound(stateRanges.cbegin(), stateRanges.cend(), c, [](char32_t c, const DfaRange& range) { return c < range.start; });
+    if (it != stateRanges.cbegin())
+    {
+        --it;
+        if (c <= it->end)
+        {
+            return it->next;
+        }
+    }
+    return dfaDeadState;
+}
+
+bool Dfa::Match(const std::u32string& s) const
+{
+    if (Empty()) return false;
+    int state = 0;
+    for (char32_t c : s)
+    {
+        state = Next(state, c);
+        if (state == dfaDeadState) return false;
+    }
+    return Accept(state);
+}
+
+int Dfa::MatchValueUtf8(const std::string& s) const
+{
+    if (Empty()) return dfaNoAcceptValue;
+    int state = 0;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(s.data());
+    const uint8_t* e = p + s.length();
+    while (p != e)
+    {
+        char32_t c = *p++;
+        if (c >= 0x80)
+        {
+            int n = 0;
+            if ((c & 0xE0) == 0xC0)
+            {
+                c &= 0x1F;
+                n = 1;
+            }
+            else if ((c & 0xF0) == 0xE0)
+            {
+                c &= 0x0F;
+                n = 2;
+            }
+            else if ((c & 0xF8) == 0xF0)
+            {
+                c &= 0x07;
+                n = 3;
+            }
+            else
+            {
+                throw soulng::unicode::UnicodeException("invalid UTF-8 sequence");
+            }
+            for (int i = 0; i < n; ++i)
+            {
+                if (p == e || (*p & 0xC0) != 0x80)
+                {
+                    throw soulng::unicode::UnicodeException("invalid UTF-8 sequence");
+                }
+                c = (c << 6) | (*p++ & 0x3F);
+            }
+        }
+        state = Next(state, c);
+        if (state == dfaDeadState) return dfaNoAcceptValue;
+    }
+    return AcceptValue(state);
+}
+
+// Epsilon closure and move follow the same edge test as the NFA simulation in Algorithm.cpp: an edge is an epsilon edge if its symbol matches eps.
+
+std::vector<NfaState*> DfaEpsilonClosure(const std::vector<NfaState*>& states)
+{
+    std::set<NfaState*> closure(states.cbegin(), states.cend());
+    std::vector<NfaState*> stack = states;
+    while (!stack.empty())
+    {
+        NfaState* s = stack.back();
+        stack.pop_back();
+        for (const NfaEdge& edge : s->Edges())
+        {
+            if (edge.GetSymbol()->Match(eps) && closure.insert(edge.Next()).second)
+            {
+                stack.push_back(edge.Next());
+            }
+        }
+    }
+    return std::vector<NfaState*>(closure.cbegin(), closure.cend());
+}
+
+std::vector<NfaState*> DfaMove(const std::vector<NfaState*>& states, char32_t c)
+{
+    std::set<NfaState*> next;
+    for (NfaState* state : states)
+    {
+        for (const NfaEdge& edge : state->Edges())
+        {
+            if (edge.GetSymbol()->Match(c))
+            {
+                next.insert(edge.Next());
+            }
+        }
+    }
+    return std::vector<NfaState*>(next.cbegin(), next.cend());
+}
+
+std::vector<char32_t> CollectBoundaries(const std::vector<Nfa>& nfas, std::map<NfaState*, int>& acceptValueMap)
+{
+    std::vector<char32_t> boundaries;
+    boundaries.push_back(0);
+    boundaries.push_back(dfaAsciiSize);
+    for (int i = 0; i < static_cast<int>(nfas.size()); ++i)
+    {
+        std::set<NfaState*> visited;
+        std::vector<NfaState*> stack(1, nfas[i].Start());
+        visited.insert(nfas[i].Start());
+        while (!stack.empty())
+        {
+            NfaState* s = stack.back();
+            stack.pop_back();
+            if (s->Accept())
+            {
+                int& acceptValue = acceptValueMap[s];
+                acceptValue = std::max(acceptValue, i);
+            }
+            for (const NfaEdge& edge : s->Edges())
+            {
+                edge.GetSymbol()->CollectBoundaries(boundaries);
+                if (visited.insert(edge.Next()).second)
+                {
+                    stack.push_back(edge.Next());
+                }
+            }
+        }
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+    return boundaries;
+}
+
+// Every symbol of the NFA either matches all or none of the characters between two consecutive boundaries,
+// so the subset construction needs to compute one move per interval instead of one per character.
+
+int GetAcceptValue(const std::vector<NfaState*>& states, const std::map<NfaState*, int>& acceptValueMap)
+{
+    int acceptValue = dfaNoAcceptValue;
+    for (NfaState* s : states)
+    {
+        if (s->Accept())
+        {
+            auto it = acceptValueMap.find(s);
+            if (it != acceptValueMap.cend())
+            {
+                acceptValue = std::max(acceptValue, it->second);
+            }
+        }
+    }
+    return acceptValue;
+}
+
+Dfa MakeDfa(const Nfa& nfa)
+{
+    if (!nfa.Start()) return Dfa();
+    return MakeDfa(std::vector<Nfa>(1, nfa));
+}
+
+Dfa MakeDfa(const std::vector<Nfa>& nfas)
+{
+    Dfa dfa;
+    if (nfas.empty()) return dfa;
+    std::map<NfaState*, int> acceptValueMap;
+    std::vector<char32_t> boundaries = CollectBoundaries(nfas, acceptValueMap);
+    std::map<std::vector<NfaState*>, int> stateMap;
+    std::vector<std::vector<NfaState*>> stateSets;
+    std::vector<NfaState*> starts;
+    for (const Nfa& nfa : nfas)
+    {
+        starts.push_back(nfa.Start());
+    }
+    std::vector<NfaState*> startSet = DfaEpsilonClosure(starts);
+    stateMap[startSet] = dfa.AddState(GetAcceptValue(startSet, acceptValueMap));
+    stateSets.push_back(startSet);
+    for (int state = 0; state < static_cast<int>(stateSets.size()); ++state)
+    {
+        for (int i = 0; i < static_cast<int>(boundaries.size()); ++i)
+        {
+            char32_t start = boundaries[i];
+            char32_t end = maxChar;
+            if (i + 1 < static_cast<int>(boundaries.size()))
+            {
+                end = boundaries[i + 1] - 1;
+            }
+            std::vector<NfaState*> nextSet = DfaEpsilonClosure(DfaMove(stateSets[state], start));
+            if (nextSet.empty()) continue;
+            int next = dfaDeadState;
+            auto it = stateMap.find(nextSet);
+            if (it != stateMap.cend())
+            {
+                next = it->second;
+            }
+            else
+            {
+                next = dfa.AddState(GetAcceptValue(nextSet, acceptValueMap));
+                stateMap[nextSet] = next;
+                stateSets.push_back(nextSet);
+            }
+            if (start < dfaAsciiSize)
+            {
+                for (char32_t c = start; c <= end; ++c)
+                {
+                    dfa.SetNext(state, c, next);
+                }
+            }
+            else
+            {
+                dfa.AddRange(state, start, end, next);
+            }
+        }
+    }
+    return dfa;
+}
+
+} } // namespace soulng::rex
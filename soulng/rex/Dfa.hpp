@@ -0,0 +1,58 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SOULNG_REX_DFA_INCLUDED
+#define SOULNG_REX_DFA_INCLUDED
+#include <soulng/rex/RexApi.hpp>
+#include <string>
+#include <vector>
+
+namespace soulng { namespace rex {
+
+class Nfa;
+
+const int dfaAsciiSize = 128;
+const int dfaDeadState = -1;
+const int dfaNoAcceptValue = -1;
+
+struct SOULNG_REX_API DfaRange
+{
+    DfaRange(char32_t start_, char32_t end_, int next_);
+    char32_t start;
+    char32_t end;
+    int next;
+};
+
+// Deterministic automaton made from one or more NFAs by subset construction. State 0 is the start state.
+// Transitions for ASCII characters are kept in a table, transitions for other characters in sorted ranges.
+// The accept value of a state is the greatest index of the NFAs that accept in that state, or dfaNoAcceptValue.
+
+class SOULNG_REX_API Dfa
+{
+public:
+    Dfa();
+    bool Empty() const { return acceptValues.empty(); }
+    int StateCount() const { return acceptValues.size(); }
+    int AddState(int acceptValue);
+    void SetNext(int state, char32_t c, int next);
+    void AddRange(int state, char32_t start, char32_t end, int next);
+    int Next(int state, char32_t c) const;
+    bool Accept(int state) const { return acceptValues[state] != dfaNoAcceptValue; }
+    int AcceptValue(int state) const { return acceptValues[state]; }
+    bool Match(const std::u32string& s) const;
+    bool MatchUtf8(const std::string& s) const { return MatchValueUtf8(s) != dfaNoAcceptValue; }
+    int MatchValueUtf8(const std::string& s) const;
+private:
+    std::vector<int> acceptValues;
+    std::vector<int> asciiNext;
+    std::vector<std::vector<DfaRange>> ranges;
+};
+
+SOULNG_REX_API Dfa MakeDfa(const Nfa& nfa);
+SOULNG_REX_API Dfa MakeDfa(const std::vector<Nfa>& nfas);
+
+} } // namespace soulng::rex
+
+#endif // SOULNG_REX_DFA_INCLUDED
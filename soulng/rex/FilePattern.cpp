@@ -0,0 +1,100 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <soulng/rex/FilePattern.hpp>
+#include <soulng/rex/Context.hpp>
+#include <soulng/rex/Match.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <cstring>
+
+namespace soulng { namespace rex {
+
+using namespace soulng::unicode;
+
+bool IsLiteralPatternChar(char32_t c)
+{
+    switch (c)
+    {
+        case '\0': case '\r': case '\n': case '{': case '}': case '\\': case '(': case ')': case '[': case ']': case '|': case '+': case '*': case '?':
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FilePatternKind ClassifyFilePattern(const std::u32string& filePattern, std::u32string& literal)
+{
+    if (filePattern.empty()) return FilePatternKind::automaton;
+    std::u32string::size_type first = filePattern.find_first_not_of('*');
+    if (first == std::u32string::npos) return FilePatternKind::any;
+    std::u32string::size_type last = filePattern.find_last_not_of('*');
+    for (std::u32string::size_type i = first; i <= last; ++i)
+    {
+        if (!IsLiteralPatternChar(filePattern[i])) return FilePatternKind::automaton;
+    }
+    literal = filePattern.substr(first, last - first + 1);
+    bool leadingStar = first > 0;
+    bool trailingStar = last < filePattern.length() - 1;
+    if (leadingStar && trailingStar) return FilePatternKind::infix;
+    if (leadingStar) return FilePatternKind::suffix;
+    if (trailingStar) return FilePatternKind::prefix;
+    return FilePatternKind::exact;
+}
+
+FilePatternMatcher::FilePatternMatcher() : kind(FilePatternKind::automaton)
+{
+}
+
+FilePatternMatcher::FilePatternMatcher(Context& context, const std::u32string& filePattern) : kind(FilePatternKind::automaton)
+{
+    std::u32string lit;
+    kind = ClassifyFilePattern(filePattern, lit);
+    if (kind == FilePatternKind::automaton)
+    {
+        nfa = CompileFilePattern(context, filePattern);
+        dfa = MakeDfa(nfa);
+    }
+    else
+    {
+        literal = ToUtf8(lit);
+    }
+}
+
+bool FilePatternMatcher::Match(const std::string& name) const
+{
+    switch (kind)
+    {
+        case FilePatternKind::any:
+        {
+            return true;
+        }
+        case FilePatternKind::exact:
+        {
+            return name == literal;
+        }
+        case FilePatternKind::prefix:
+        {
+            return name.length() >= literal.length() && std::memcmp(name.data(), literal.data(), literal.length()) == 0;
+        }
+        case FilePatternKind::suffix:
+        {
+            return name.length() >= literal.length() && std::memcmp(name.data() + name.length() - literal.length(), literal.data(), literal.length()) == 0;
+        }
+        case FilePatternKind::infix:
+        {
+            return name.find(literal) != std::string::npos;
+        }
+    }
+    return dfa.MatchUtf8(name);
+}
+
+std::shared_ptr<const FilePatternMatcher> GetCachedFilePatternMatcher(const std::u32string& filePattern)
+{
+    static Context context;
+    return context.GetFilePatternMatcher(filePattern);
+}
+
+} } // namespace soulng::rex
@@ -0,0 +1,48 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SOULNG_REX_FILE_PATTERN_INCLUDED
+#define SOULNG_REX_FILE_PATTERN_INCLUDED
+#include <soulng/rex/Dfa.hpp>
+#include <soulng/rex/Nfa.hpp>
+#include <memory>
+
+namespace soulng { namespace rex {
+
+class Context;
+
+enum class FilePatternKind : int
+{
+    any, exact, prefix, suffix, infix, automaton
+};
+
+// Matches UTF-8 file names against a file pattern. The patterns '*', 'name', 'prefix*', '*suffix' and '*infix*' are matched by comparing bytes.
+// Other patterns are compiled to a DFA.
+
+class SOULNG_REX_API FilePatternMatcher
+{
+public:
+    FilePatternMatcher();
+    FilePatternMatcher(Context& context, const std::u32string& filePattern);
+    FilePatternKind Kind() const { return kind; }
+    const std::string& Literal() const { return literal; }
+    const Nfa& GetNfa() const { return nfa; }
+    bool Match(const std::string& name) const;
+private:
+    FilePatternKind kind;
+    std::string literal;
+    Nfa nfa;
+    Dfa dfa;
+};
+
+SOULNG_REX_API FilePatternKind ClassifyFilePattern(const std::u32string& filePattern, std::u32string& literal);
+
+// Returns a compiled matcher from a process-wide cache shared by all threads.
+
+SOULNG_REX_API std::shared_ptr<const FilePatternMatcher> GetCachedFilePatternMatcher(const std::u32string& filePattern);
+
+} } // namespace soulng::rex
+
+#endif // SOULNG_REX_FILE_PATTERN_INCLUDED
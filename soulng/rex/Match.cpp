@@ -8,6 +8,9 @@
 #include <soulng/rex/RexLexer.hpp>
 #include <soulng/rex/RexParser.hpp>
 #include <soulng/rex/Algorithm.hpp>
+#include <soulng/rex/Dfa.hpp>
+#include <soulng/rex/FilePattern.hpp>
+#include <soulng/util/Unicode.hpp>
 
 namespace soulng { namespace rex {
 
@@ -29,7 +32,7 @@ std::u32string MakeRegularExpressionPatternFromFilePattern(const std::u32string&
 
 bool FilePatternMatch(const std::u32string& filePath, const std::u32string& filePattern)
 {
-    return PatternMatch(filePath, MakeRegularExpressionPatternFromFilePattern(filePattern));
+    return GetCachedFilePatternMatcher(filePattern)->Match(soulng::unicode::ToUtf8(filePath));
 }
 
 bool PatternMatch(const std::u32string& str, const std::u32string& regularExpressionPattern)
@@ -55,4 +58,9 @@ bool PatternMatch(const std::u32string& str, Nfa& nfa)
     return Match(nfa, str);
 }
 
+bool PatternMatch(const std::u32string& str, const Dfa& dfa)
+{
+    return dfa.Match(str);
+}
+
 } } // namespace soulng::rex
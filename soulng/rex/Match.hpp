@@ -11,11 +11,13 @@
 namespace soulng { namespace rex {
 
 class Nfa;
+class Dfa;
 class Context;
 
 SOULNG_REX_API bool FilePatternMatch(const std::u32string& filePath, const std::u32string& filePattern);
 SOULNG_REX_API bool PatternMatch(const std::u32string& str, const std::u32string& regularExpressionPattern);
 SOULNG_REX_API bool PatternMatch(const std::u32string& str, Nfa& nfa);
+SOULNG_REX_API bool PatternMatch(const std::u32string& str, const Dfa& dfa);
 SOULNG_REX_API Nfa CompileRegularExpressionPattern(Context& context, const std::u32string& regularExpressionPattern);
 SOULNG_REX_API Nfa CompileFilePattern(Context& context, const std::u32string& filePattern);
 
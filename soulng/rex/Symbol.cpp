@@ -20,6 +20,15 @@ bool Char::Match(char32_t c)
     return c == chr;
 }
 
+void Char::CollectBoundaries(std::vector<char32_t>& boundaries)
+{
+    boundaries.push_back(chr);
+    if (chr != maxChar)
+    {
+        boundaries.push_back(chr + 1);
+    }
+}
+
 bool Any::Match(char32_t c)
 {
     return true;
@@ -34,6 +43,15 @@ bool Range::Match(char32_t c)
     return c >= start && c <= end;
 }
 
+void Range::CollectBoundaries(std::vector<char32_t>& boundaries)
+{
+    boundaries.push_back(start);
+    if (end != maxChar)
+    {
+        boundaries.push_back(end + 1);
+    }
+}
+
 Class::Class() : inverse(false)
 {
 }
@@ -52,6 +70,14 @@ bool Class::Match(char32_t c)
     return match != inverse;
 }
 
+void Class::CollectBoundaries(std::vector<char32_t>& boundaries)
+{
+    for (Symbol* symbol : symbols)
+    {
+        symbol->CollectBoundaries(boundaries);
+    }
+}
+
 void Class::AddSymbol(Symbol* symbol)
 {
     symbols.push_back(symbol);
@@ -11,12 +11,14 @@
 namespace soulng { namespace rex {
 
 const char32_t eps = '\0';
+const char32_t maxChar = 0xFFFFFFFF;
 
 class SOULNG_REX_API Symbol
 {
 public:
     virtual ~Symbol();
     virtual bool Match(char32_t c) = 0;
+    virtual void CollectBoundaries(std::vector<char32_t>& boundaries) {}
 };
 
 class SOULNG_REX_API Char : public Symbol
@@ -24,6 +26,7 @@ class SOULNG_REX_API Char : public Symbol
 public:
     Char(char32_t chr_);
     bool Match(char32_t c) override;
+    void CollectBoundaries(std::vector<char32_t>& boundaries) override;
     char32_t Chr() const { return chr; }
 private:
     char32_t chr;
@@ -40,6 +43,7 @@ class SOULNG_REX_API Range : public Symbol
 public:
     Range(char32_t start_, char32_t end_);
     bool Match(char32_t c) override;
+    void CollectBoundaries(std::vector<char32_t>& boundaries) override;
     char32_t Start() const { return start; }
     char32_t End() const { return end; }
 private:
@@ -64,6 +68,7 @@ class SOULNG_REX_API Class : public Symbol
 public:
     Class();
     bool Match(char32_t c) override;
+    void CollectBoundaries(std::vector<char32_t>& boundaries) override;
     void SetInverse() { inverse = true; }
     void AddSymbol(Symbol* symbol);
 private:
@@ -22,7 +22,7 @@ BZip2Stream::BZip2Stream(CompressionMode mode_, Stream& underlyingStream_, int64
 BZip2Stream::BZip2Stream(CompressionMode mode_, Stream& underlyingStream_, int64_t bufferSize_, int compressionLevel_, int compressionWorkFactor_) :
     Stream(), mode(mode_), underlyingStream(underlyingStream_), bufferSize(bufferSize_), compressionLevel(compressionLevel_), compressionWorkFactor(compressionWorkFactor_),
     inAvail(0), endOfInput(false), endOfStream(false), in(new uint8_t[bufferSize]), outHave(0), outAvail(0), outPos(0), out(new uint8_t[bufferSize]),
-    handle(nullptr)
+    handle(nullptr), finished(false)
 {
     SetPosition(underlyingStream.Position());
     int ret = bz2_init(int32_t(mode), compressionLevel, compressionWorkFactor, &handle);
@@ -38,7 +38,7 @@ BZip2Stream::~BZip2Stream()
     {
         try
         {
-            if (mode == CompressionMode::compress)
+            if (mode == CompressionMode::compress && !finished)
             {
                 Finish();
             }
@@ -153,8 +153,13 @@ void BZip2Stream::Write(uint8_t* buf, int64_t count)
     SetPosition(Position() + bytesWritten);
 }
 
+// Compresses the remaining input and writes the end of the compressed stream. Called by the destructor if it has not been called explicitly,
+// but then errors are ignored.
+
 void BZip2Stream::Finish()
 {
+    if (finished) return;
+    finished = true;
     int ret = 0;
     do
     {
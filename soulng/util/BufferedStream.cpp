@@ -108,6 +108,22 @@ int64_t BufferedStream::Tell()
     return baseStream.Tell() - bytesAvailable;
 }
 
+// Skips the buffered bytes first and lets the base stream skip the rest.
+
+int64_t BufferedStream::Skip(int64_t count)
+{
+    Flush();
+    int64_t bytesSkipped = std::min(bytesAvailable, count);
+    pos += bytesSkipped;
+    bytesAvailable -= bytesSkipped;
+    if (bytesSkipped < count)
+    {
+        bytesSkipped += baseStream.Skip(count - bytesSkipped);
+    }
+    SetPosition(Position() + bytesSkipped);
+    return bytesSkipped;
+}
+
 void BufferedStream::FillBuf()
 {
     bytesAvailable = baseStream.Read(buffer.get(), bufferSize);
@@ -23,6 +23,7 @@ public:
     void Flush() override;
     void Seek(int64_t pos, Origin origin) override;
     int64_t Tell() override;
+    int64_t Skip(int64_t count) override;
     Stream& BaseStream() { return baseStream; }
 private:
     void FillBuf();
@@ -0,0 +1,247 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <soulng/util/ChecksumFrameStream.hpp>
+#include <soulng/util/Crc32.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace soulng { namespace util {
+
+const int frameHeaderSize = 8;
+
+void EncodeUInt32(uint32_t x, uint8_t* buf)
+{
+    buf[0] = static_cast<uint8_t>(x);
+    buf[1] = static_cast<uint8_t>(x >> 8);
+    buf[2] = static_cast<uint8_t>(x >> 16);
+    buf[3] = static_cast<uint8_t>(x >> 24);
+}
+
+uint32_t DecodeUInt32(const uint8_t* buf)
+{
+    return static_cast<uint32_t>(buf[0]) | (static_cast<uint32_t>(buf[1]) << 8) | (static_cast<uint32_t>(buf[2]) << 16) | (static_cast<uint32_t>(buf[3]) << 24);
+}
+
+ChecksumFrameStream::ChecksumFrameStream(FrameMode mode_, Stream& underlyingStream_) : ChecksumFrameStream(mode_, underlyingStream_, defaultChecksumFrameSize)
+{
+}
+
+ChecksumFrameStream::ChecksumFrameStream(FrameMode mode_, Stream& underlyingStream_, int64_t frameSize_) :
+    Stream(), mode(mode_), underlyingStream(underlyingStream_), frameSize(frameSize_), frame(new uint8_t[frameSize]), pos(0), end(0), endOfStream(false), finished(false)
+{
+    SetPosition(underlyingStream.Position());
+}
+
+ChecksumFrameStream::~ChecksumFrameStream()
+{
+    if (mode == FrameMode::write && !finished)
+    {
+        try
+        {
+            Finish();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+int ChecksumFrameStream::ReadByte()
+{
+    uint8_t x = 0;
+    int64_t bytesRead = Read(&x, 1);
+    if (bytesRead == 0)
+    {
+        return -1;
+    }
+    return x;
+}
+
+int64_t ChecksumFrameStream::Read(uint8_t* buf, int64_t count)
+{
+    if (mode != FrameMode::read)
+    {
+        throw std::runtime_error("checksum frame stream: cannot read in 'write' frame mode");
+    }
+    int64_t bytesRead = 0;
+    while (bytesRead < count)
+    {
+        if (pos == end)
+        {
+            if (endOfStream) break;
+            ReadFrame();
+            if (endOfStream) break;
+        }
+        int64_t n = std::min(end - pos, count - bytesRead);
+        std::memcpy(buf + bytesRead, frame.get() + pos, n);
+        pos += n;
+        bytesRead += n;
+    }
+    SetPosition(Position() + bytesRead);
+    return bytesRead;
+}
+
+void ChecksumFrameStream::Write(uint8_t x)
+{
+    Write(&x, 1);
+}
+
+void ChecksumFrameStream::Write(uint8_t* buf, int64_t count)
+{
+    if (mode != FrameMode::write)
+    {
+        throw std::runtime_error("checksum frame stream: cannot write in 'read' frame mode");
+    }
+    if (finished)
+    {
+        throw std::runtime_error("checksum frame stream: cannot write after the stream has been finished");
+    }
+    int64_t bytesWritten = 0;
+    while (bytesWritten < count)
+    {
+        int64_t n = std::min(frameSize - end, count - bytesWritten);
+        std::memcpy(frame.get() + end, buf + bytesWritten, n);
+        end += n;
+        bytesWritten += n;
+        if (end == frameSize)
+        {
+            WriteFrame();
+        }
+    }
+    SetPosition(Position() + bytesWritten);
+}
+
+void ChecksumFrameStream::Flush()
+{
+    underlyingStream.Flush();
+}
+
+// The stream is marked finished before anything is written, so the destructor does not try again after a failed write.
+
+void ChecksumFrameStream::Finish()
+{
+    if (mode != FrameMode::write || finished) return;
+    finished = true;
+    if (end > 0)
+    {
+        WriteFrame();
+    }
+    WriteFrame();
+    underlyingStream.Flush();
+}
+
+void ChecksumFrameStream::WriteFrame()
+{
+    uint8_t header[frameHeaderSize];
+    EncodeUInt32(static_cast<uint32_t>(end), header);
+    EncodeUInt32(Crc32c(0, frame.get(), end), header + 4);
+    underlyingStream.Write(header, frameHeaderSize);
+    if (end > 0)
+    {
+        underlyingStream.Write(frame.get(), end);
+    }
+    end = 0;
+}
+
+// Whole frames that fit in the skipped range are passed over in the underlying stream without reading them, so their checksums are not verified.
+// A frame that is skipped only in part is read and verified as usual, because the rest of it is returned by the next read.
+
+int64_t ChecksumFrameStream::Skip(int64_t count)
+{
+    if (mode != FrameMode::read)
+    {
+        throw std::runtime_error("checksum frame stream: cannot skip in 'write' frame mode");
+    }
+    int64_t bytesSkipped = std::min(end - pos, count);
+    pos += bytesSkipped;
+    while (bytesSkipped < count && !endOfStream)
+    {
+        int64_t frameOffset = underlyingStream.Position();
+        uint32_t checksum = 0;
+        int64_t length = ReadFrameHeader(frameOffset, checksum);
+        if (length > 0 && length <= count - bytesSkipped)
+        {
+            int64_t n = underlyingStream.Skip(length);
+            if (n != length)
+            {
+                throw std::runtime_error("checksum frame stream: stream truncated at offset " + std::to_string(frameOffset + frameHeaderSize + n) +
+                    ": frame at offset " + std::to_string(frameOffset) + " has " + std::to_string(n) + " of " + std::to_string(length) + " bytes");
+            }
+            pos = 0;
+            end = 0;
+            bytesSkipped += length;
+        }
+        else
+        {
+            ReadFrameData(frameOffset, length, checksum);
+            int64_t n = std::min(end, count - bytesSkipped);
+            pos = n;
+            bytesSkipped += n;
+        }
+    }
+    SetPosition(Position() + bytesSkipped);
+    return bytesSkipped;
+}
+
+void ChecksumFrameStream::ReadFrame()
+{
+    int64_t frameOffset = underlyingStream.Position();
+    uint32_t checksum = 0;
+    int64_t length = ReadFrameHeader(frameOffset, checksum);
+    ReadFrameData(frameOffset, length, checksum);
+}
+
+int64_t ChecksumFrameStream::ReadFrameHeader(int64_t frameOffset, uint32_t& checksum)
+{
+    uint8_t header[frameHeaderSize];
+    if (ReadUnderlying(header, frameHeaderSize) != frameHeaderSize)
+    {
+        throw std::runtime_error("checksum frame stream: stream truncated at offset " + std::to_string(frameOffset) + ": frame header missing");
+    }
+    int64_t length = DecodeUInt32(header);
+    checksum = DecodeUInt32(header + 4);
+    if (length > frameSize)
+    {
+        throw std::runtime_error("checksum frame stream: invalid frame length " + std::to_string(length) + " at offset " + std::to_string(frameOffset));
+    }
+    return length;
+}
+
+void ChecksumFrameStream::ReadFrameData(int64_t frameOffset, int64_t length, uint32_t checksum)
+{
+    int64_t bytesRead = ReadUnderlying(frame.get(), length);
+    if (bytesRead != length)
+    {
+        throw std::runtime_error("checksum frame stream: stream truncated at offset " + std::to_string(frameOffset + frameHeaderSize + bytesRead) +
+            ": frame at offset " + std::to_string(frameOffset) + " has " + std::to_string(bytesRead) + " of " + std::to_string(length) + " bytes");
+    }
+    if (Crc32c(0, frame.get(), length) != checksum)
+    {
+        throw std::runtime_error("checksum frame stream: checksum mismatch in frame at offset " + std::to_string(frameOffset));
+    }
+    pos = 0;
+    end = length;
+    if (length == 0)
+    {
+        endOfStream = true;
+    }
+}
+
+int64_t ChecksumFrameStream::ReadUnderlying(uint8_t* buf, int64_t count)
+{
+    int64_t bytesRead = 0;
+    while (bytesRead < count)
+    {
+        int64_t n = underlyingStream.Read(buf + bytesRead, count - bytesRead);
+        if (n <= 0) break;
+        bytesRead += n;
+    }
+    return bytesRead;
+}
+
+} } // namespace soulng::util
@@ -0,0 +1,57 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SOULNG_UTIL_CHECKSUM_FRAME_STREAM_INCLUDED
+#define SOULNG_UTIL_CHECKSUM_FRAME_STREAM_INCLUDED
+#include <soulng/util/Stream.hpp>
+#include <memory>
+
+namespace soulng { namespace util {
+
+enum class FrameMode : int
+{
+    write = 0, read = 1
+};
+
+const int64_t defaultChecksumFrameSize = 1024 * 1024;
+
+// Splits data into frames of frameSize bytes. Each frame is preceded by its 32-bit length and CRC-32C checksum.
+// In write mode Finish writes the last frame and the empty frame that ends the stream. If Finish has not been called,
+// the destructor writes them, but then a failed write goes unnoticed.
+// In read mode each frame is verified as a whole before any of its bytes are returned. Skip passes over whole frames without verifying them.
+// A checksum mismatch or a stream ending before the empty frame throws an exception that reports the offset of the frame in the underlying stream.
+
+class UTIL_API ChecksumFrameStream : public Stream
+{
+public:
+    ChecksumFrameStream(FrameMode mode_, Stream& underlyingStream_);
+    ChecksumFrameStream(FrameMode mode_, Stream& underlyingStream_, int64_t frameSize_);
+    ~ChecksumFrameStream() override;
+    int ReadByte() override;
+    int64_t Read(uint8_t* buf, int64_t count) override;
+    void Write(uint8_t x) override;
+    void Write(uint8_t* buf, int64_t count) override;
+    void Flush() override;
+    int64_t Skip(int64_t count) override;
+    void Finish();
+private:
+    void WriteFrame();
+    void ReadFrame();
+    int64_t ReadFrameHeader(int64_t frameOffset, uint32_t& checksum);
+    void ReadFrameData(int64_t frameOffset, int64_t length, uint32_t checksum);
+    int64_t ReadUnderlying(uint8_t* buf, int64_t count);
+    FrameMode mode;
+    Stream& underlyingStream;
+    int64_t frameSize;
+    std::unique_ptr<uint8_t[]> frame;
+    int64_t pos;
+    int64_t end;
+    bool endOfStream;
+    bool finished;
+};
+
+} } // namespace soulng::util
+
+#endif // SOULNG_UTIL_CHECKSUM_FRAME_STREAM_INCLUDED
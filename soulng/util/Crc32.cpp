@@ -0,0 +1,129 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <soulng/util/Crc32.hpp>
+#include <cstring>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <nmmintrin.h>
+#define SOULNG_UTIL_CRC32C_SSE42
+#define SOULNG_UTIL_CRC32C_TARGET
+#elif defined(__GNUC__) && defined(__x86_64__)
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define SOULNG_UTIL_CRC32C_SSE42
+#define SOULNG_UTIL_CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif
+
+namespace soulng { namespace util {
+
+const uint32_t crc32cPolynomial = 0x82F63B78u;
+
+class Crc32cTable
+{
+public:
+    Crc32cTable();
+    uint32_t entry[8][256];
+};
+
+Crc32cTable::Crc32cTable()
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ crc32cPolynomial : crc >> 1;
+        }
+        entry[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        for (int t = 1; t < 8; ++t)
+        {
+            entry[t][i] = (entry[t - 1][i] >> 8) ^ entry[0][entry[t - 1][i] & 0xFF];
+        }
+    }
+}
+
+uint32_t Crc32cSoftware(uint32_t crc, const uint8_t* data, int64_t size)
+{
+    static Crc32cTable table;
+    while (size >= 8)
+    {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = table.entry[7][low & 0xFF] ^ table.entry[6][(low >> 8) & 0xFF] ^ table.entry[5][(low >> 16) & 0xFF] ^ table.entry[4][low >> 24] ^
+            table.entry[3][high & 0xFF] ^ table.entry[2][(high >> 8) & 0xFF] ^ table.entry[1][(high >> 16) & 0xFF] ^ table.entry[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size > 0)
+    {
+        crc = (crc >> 8) ^ table.entry[0][(crc ^ *data) & 0xFF];
+        ++data;
+        --size;
+    }
+    return crc;
+}
+
+#ifdef SOULNG_UTIL_CRC32C_SSE42
+
+bool HasSse42()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & (1u << 20)) != 0;
+#endif
+}
+
+SOULNG_UTIL_CRC32C_TARGET uint32_t Crc32cHardware(uint32_t crc, const uint8_t* data, int64_t size)
+{
+    uint64_t c = crc;
+    while (size >= 8)
+    {
+        uint64_t x = 0;
+        std::memcpy(&x, data, 8);
+        c = _mm_crc32_u64(c, x);
+        data += 8;
+        size -= 8;
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    while (size > 0)
+    {
+        c32 = _mm_crc32_u8(c32, *data);
+        ++data;
+        --size;
+    }
+    return c32;
+}
+
+#endif
+
+uint32_t Crc32c(uint32_t crc, const uint8_t* data, int64_t size)
+{
+    crc = ~crc;
+#ifdef SOULNG_UTIL_CRC32C_SSE42
+    static bool hasSse42 = HasSse42();
+    if (hasSse42)
+    {
+        return ~Crc32cHardware(crc, data, size);
+    }
+#endif
+    return ~Crc32cSoftware(crc, data, size);
+}
+
+} } // namespace soulng::util
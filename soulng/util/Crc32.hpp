@@ -0,0 +1,20 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef SOULNG_UTIL_CRC32_INCLUDED
+#define SOULNG_UTIL_CRC32_INCLUDED
+#include <soulng/util/UtilApi.hpp>
+#include <stdint.h>
+
+namespace soulng { namespace util {
+
+// CRC-32C (Castagnoli) checksum. Uses the SSE 4.2 crc32 instruction when the processor supports it, a table-driven implementation otherwise.
+// Pass the returned value as crc to continue the checksum over the next block of data. Start with crc = 0.
+
+UTIL_API uint32_t Crc32c(uint32_t crc, const uint8_t* data, int64_t size);
+
+} } // namespace soulng::util
+
+#endif // SOULNG_UTIL_CRC32_INCLUDED
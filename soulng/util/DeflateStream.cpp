@@ -21,7 +21,7 @@ DeflateStream::DeflateStream(CompressionMode mode_, Stream& underlyingStream_, i
 DeflateStream::DeflateStream(CompressionMode mode_, Stream& underlyingStream_, int64_t bufferSize_, int compressionLevel_) : 
     Stream(), mode(mode_), underlyingStream(underlyingStream_), bufferSize(bufferSize_), compressionLevel(compressionLevel_), 
     inAvail(0), in(new uint8_t[bufferSize]), outAvail(0), outPos(0), outHave(0), endOfInput(false), endOfStream(false), out(new uint8_t[bufferSize]), 
-    handle(nullptr)
+    handle(nullptr), finished(false)
 {
     SetPosition(underlyingStream.Position());
     int ret = zlib_init(int32_t(mode), compressionLevel, &handle);
@@ -37,7 +37,7 @@ DeflateStream::~DeflateStream()
     {
         try
         {
-            if (mode == CompressionMode::compress)
+            if (mode == CompressionMode::compress && !finished)
             {
                 Finish();
             }
@@ -152,8 +152,13 @@ void DeflateStream::Write(uint8_t* buf, int64_t count)
     SetPosition(Position() + bytesWritten);
 }
 
+// Compresses the remaining input and writes the end of the compressed stream. Called by the destructor if it has not been called explicitly,
+// but then errors are ignored.
+
 void DeflateStream::Finish()
 {
+    if (finished) return;
+    finished = true;
     do
     {
         uint32_t have = 0u;
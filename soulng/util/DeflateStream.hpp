@@ -30,8 +30,8 @@ public:
     int64_t Read(uint8_t* buf, int64_t count) override;
     void Write(uint8_t x) override;
     void Write(uint8_t* buf, int64_t count) override;
-private:
     void Finish();
+private:
     CompressionMode mode;
     Stream& underlyingStream;
     int64_t bufferSize;
@@ -45,6 +45,7 @@ private:
     bool endOfStream;
     std::unique_ptr<uint8_t[]> out;
     void* handle;
+    bool finished;
 };
 
 } } // namespace soulng::util
@@ -6,6 +6,7 @@
 #include <soulng/util/FileStream.hpp>
 #include <soulng/util/TextUtils.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 namespace soulng { namespace util {
@@ -189,6 +190,15 @@ void FileStream::Seek(int64_t pos, Origin origin)
     }
 }
 
+// Skips by seeking, so the skipped bytes are not read. Skipping stops at the end of the file.
+
+int64_t FileStream::Skip(int64_t count)
+{
+    int64_t bytesSkipped = std::max(static_cast<int64_t>(0), std::min(count, Size() - Position()));
+    Seek(bytesSkipped, Origin::seekCur);
+    return bytesSkipped;
+}
+
 int64_t FileStream::Tell()
 {
     int64_t result = std::ftell(file);
@@ -47,6 +47,7 @@ public:
     void Write(uint8_t* buf, int64_t count) override;
     void Flush() override;
     void Seek(int64_t pos, Origin origin) override;
+    int64_t Skip(int64_t count) override;
     int64_t Tell() override;
     int64_t Size() const;
 private:
@@ -4,6 +4,7 @@
 // =================================
 
 #include <soulng/util/MemoryStream.hpp>
+#include <algorithm>
 
 namespace soulng { namespace util {
 
@@ -87,6 +88,14 @@ int64_t MemoryStream::Tell()
     return readPos;
 }
 
+int64_t MemoryStream::Skip(int64_t count)
+{
+    int64_t bytesSkipped = std::max(static_cast<int64_t>(0), std::min(count, size - readPos));
+    readPos += bytesSkipped;
+    SetPosition(Position() + bytesSkipped);
+    return bytesSkipped;
+}
+
 void MemoryStream::SetFromContent()
 { 
     data = content.data(); 
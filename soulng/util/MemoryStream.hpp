@@ -21,6 +21,7 @@ public:
     void Write(uint8_t* buf, int64_t count) override;
     void Seek(int64_t pos, Origin origin) override;
     int64_t Tell() override;
+    int64_t Skip(int64_t count) override;
     uint8_t* Data() { return data; }
     int64_t Size() const { return size; }
     int64_t ReadPos() const { return readPos; }
@@ -39,6 +39,21 @@ int64_t Stream::Tell()
     throw std::runtime_error("tell not supported");
 }
 
+// Skips count bytes by reading them. Returns the number of bytes skipped, which is less than count only if the stream ends first.
+
+int64_t Stream::Skip(int64_t count)
+{
+    uint8_t buf[4096];
+    int64_t bytesSkipped = 0;
+    while (bytesSkipped < count)
+    {
+        int64_t n = Read(buf, std::min(count - bytesSkipped, static_cast<int64_t>(sizeof(buf))));
+        if (n <= 0) break;
+        bytesSkipped += n;
+    }
+    return bytesSkipped;
+}
+
 void Stream::AddObserver(StreamObserver* observer)
 {
     if (std::find(observers.begin(), observers.end(), observer) == observers.end())
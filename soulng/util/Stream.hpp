@@ -41,6 +41,7 @@ public:
     virtual void Flush();
     virtual void Seek(int64_t pos, Origin origin);
     virtual int64_t Tell();
+    virtual int64_t Skip(int64_t count);
     void CopyTo(Stream& destination);
     void CopyTo(Stream& destination, int64_t bufferSize);
     int64_t Position() const { return position; }
@@ -0,0 +1,99 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wing/DirectoryWatcher.hpp>
+#include <wing/Wing.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <algorithm>
+
+namespace wing {
+
+using namespace soulng::unicode;
+
+const int directoryChangeBufferSize = 64 * 1024;
+
+DirectoryChanges::DirectoryChanges() : overflow(false)
+{
+}
+
+DirectoryWatcher::DirectoryWatcher(const std::string& directoryPath_) : 
+    directoryPath(directoryPath_), directoryHandle(INVALID_HANDLE_VALUE), eventHandle(nullptr), overlapped(new OVERLAPPED()), buffer(directoryChangeBufferSize)
+{
+    std::u16string path = ToUtf16(directoryPath);
+    directoryHandle = CreateFileW((LPCWSTR)path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (directoryHandle == INVALID_HANDLE_VALUE)
+    {
+        WindowsException ex(GetLastError());
+        delete static_cast<OVERLAPPED*>(overlapped);
+        throw std::runtime_error("could not watch directory '" + directoryPath + "': " + ex.ErrorMessage());
+    }
+    eventHandle = CreateEventW(nullptr, true, false, nullptr);
+    static_cast<OVERLAPPED*>(overlapped)->hEvent = eventHandle;
+    BeginRead();
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    CancelIo(directoryHandle);
+    DWORD bytesTransferred = 0;
+    GetOverlappedResult(directoryHandle, static_cast<OVERLAPPED*>(overlapped), &bytesTransferred, true);
+    CloseHandle(directoryHandle);
+    CloseHandle(eventHandle);
+    delete static_cast<OVERLAPPED*>(overlapped);
+}
+
+void DirectoryWatcher::BeginRead()
+{
+    ResetEvent(eventHandle);
+    DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+    if (!ReadDirectoryChangesW(directoryHandle, buffer.data(), static_cast<DWORD>(buffer.size()), true, filter, nullptr, static_cast<OVERLAPPED*>(overlapped), nullptr))
+    {
+        throw std::runtime_error("could not watch directory '" + directoryPath + "': " + WindowsException(GetLastError()).ErrorMessage());
+    }
+}
+
+// Returns false if no changes arrived within the timeout. Otherwise adds the changed paths to changes and starts waiting for the next changes.
+
+bool DirectoryWatcher::WaitForChanges(int timeoutMilliseconds, DirectoryChanges& changes)
+{
+    DWORD result = WaitForSingleObject(eventHandle, timeoutMilliseconds);
+    if (result == WAIT_TIMEOUT)
+    {
+        return false;
+    }
+    DWORD bytesTransferred = 0;
+    if (!GetOverlappedResult(directoryHandle, static_cast<OVERLAPPED*>(overlapped), &bytesTransferred, false))
+    {
+        DWORD errorCode = GetLastError();
+        if (errorCode != ERROR_NOTIFY_ENUM_DIR)
+        {
+            throw std::runtime_error("could not watch directory '" + directoryPath + "': " + WindowsException(errorCode).ErrorMessage());
+        }
+        bytesTransferred = 0;
+    }
+    if (bytesTransferred == 0)
+    {
+        changes.overflow = true;
+    }
+    else
+    {
+        DWORD offset = 0;
+        while (true)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer.data() + offset);
+            std::u16string fileName(reinterpret_cast<const char16_t*>(info->FileName), info->FileNameLength / sizeof(char16_t));
+            std::string path = ToUtf8(fileName);
+            std::replace(path.begin(), path.end(), '\\', '/');
+            changes.paths.push_back(path);
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+    }
+    BeginRead();
+    return true;
+}
+
+} // wing
@@ -0,0 +1,43 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WING_DIRECTORY_WATCHER_INCLUDED
+#define WING_DIRECTORY_WATCHER_INCLUDED
+#include <wing/WingApi.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace wing {
+
+struct WING_API DirectoryChanges
+{
+    DirectoryChanges();
+    std::vector<std::string> paths;
+    bool overflow;
+};
+
+// Receives change notifications for a directory tree. The changed paths are relative to the watched directory and use '/' as the separator.
+// If changes arrive faster than they are read, the system discards them and overflow is set: any file in the tree may then have changed.
+
+class WING_API DirectoryWatcher
+{
+public:
+    DirectoryWatcher(const std::string& directoryPath_);
+    ~DirectoryWatcher();
+    const std::string& DirectoryPath() const { return directoryPath; }
+    bool WaitForChanges(int timeoutMilliseconds, DirectoryChanges& changes);
+private:
+    void BeginRead();
+    std::string directoryPath;
+    void* directoryHandle;
+    void* eventHandle;
+    void* overlapped;
+    std::vector<uint8_t> buffer;
+};
+
+} // wing
+
+#endif // WING_DIRECTORY_WATCHER_INCLUDED
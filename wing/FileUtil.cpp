@@ -4,11 +4,15 @@
 // =================================
 
 #include <wing/FileUtil.hpp>
+#include <soulng/util/Path.hpp>
+#include <soulng/util/TextUtils.hpp>
 #include <soulng/util/Unicode.hpp>
+#include <boost/filesystem.hpp>
 
 namespace wing {
 
 using namespace soulng::unicode;
+using namespace soulng::util;
 
 void MoveFile(const std::string& from, const std::string& to)
 {
@@ -46,4 +50,78 @@ void RemoveOnReboot(const std::string& path)
     }
 }
 
+DirectoryEntry::DirectoryEntry(const std::string& name_, DirectoryEntryKind kind_, uint64_t size_, std::time_t time_) : name(name_), kind(kind_), size(size_), time(time_)
+{
+}
+
+std::time_t FileTimeToTime(const FILETIME& fileTime)
+{
+    const uint64_t ticksPerSecond = 10000000;
+    const uint64_t epochDifference = 11644473600;
+    uint64_t ticks = (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+    return static_cast<std::time_t>(ticks / ticksPerSecond - epochDifference);
+}
+
+DirectoryEntry ResolveReparsePoint(const std::string& directoryPath, const std::string& name)
+{
+    boost::filesystem::path path = MakeNativeBoostPath(Path::Combine(directoryPath, name));
+    boost::system::error_code ec;
+    boost::filesystem::file_status status = boost::filesystem::status(path, ec);
+    if (!ec)
+    {
+        if (boost::filesystem::is_directory(status))
+        {
+            return DirectoryEntry(name, DirectoryEntryKind::directory, 0, boost::filesystem::last_write_time(path));
+        }
+        else if (boost::filesystem::is_regular_file(status))
+        {
+            return DirectoryEntry(name, DirectoryEntryKind::file, boost::filesystem::file_size(path), boost::filesystem::last_write_time(path));
+        }
+    }
+    return DirectoryEntry(name, DirectoryEntryKind::other, 0, std::time_t());
+}
+
+std::vector<DirectoryEntry> ReadDirectory(const std::string& directoryPath)
+{
+    std::vector<DirectoryEntry> entries;
+    std::u16string pattern = ToUtf16(Path::Combine(directoryPath, "*"));
+    WIN32_FIND_DATAW findData;
+    HANDLE handle = FindFirstFileExW((LPCWSTR)pattern.c_str(), FindExInfoBasic, &findData, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        DWORD errorCode = GetLastError();
+        if (errorCode == ERROR_FILE_NOT_FOUND)
+        {
+            return entries;
+        }
+        throw std::runtime_error("could not iterate directory '" + directoryPath + "': " + WindowsException(errorCode).ErrorMessage());
+    }
+    do
+    {
+        std::string name = ToUtf8(std::u16string((const char16_t*)findData.cFileName));
+        if (name == "." || name == "..") continue;
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+        {
+            entries.push_back(ResolveReparsePoint(directoryPath, name));
+        }
+        else if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        {
+            entries.push_back(DirectoryEntry(name, DirectoryEntryKind::directory, 0, FileTimeToTime(findData.ftLastWriteTime)));
+        }
+        else
+        {
+            uint64_t size = (static_cast<uint64_t>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
+            entries.push_back(DirectoryEntry(name, DirectoryEntryKind::file, size, FileTimeToTime(findData.ftLastWriteTime)));
+        }
+    }
+    while (FindNextFileW(handle, &findData));
+    DWORD errorCode = GetLastError();
+    FindClose(handle);
+    if (errorCode != ERROR_NO_MORE_FILES)
+    {
+        throw std::runtime_error("could not iterate directory '" + directoryPath + "': " + WindowsException(errorCode).ErrorMessage());
+    }
+    return entries;
+}
+
 } // wing
@@ -6,6 +6,8 @@
 #ifndef WING_FILE_UTIL_INCLUDED
 #define WING_FILE_UTIL_INCLUDED
 #include <wing/Wing.hpp>
+#include <ctime>
+#include <vector>
 
 #undef MoveFile
 
@@ -15,6 +17,25 @@ void WING_API MoveFile(const std::string& from, const std::string& to);
 void WING_API MoveFile(const std::string& from, const std::string& to, bool allowCopy, bool replaceExisting);
 void WING_API RemoveOnReboot(const std::string& path);
 
+enum class DirectoryEntryKind : int
+{
+    other, directory, file
+};
+
+struct WING_API DirectoryEntry
+{
+    DirectoryEntry(const std::string& name_, DirectoryEntryKind kind_, uint64_t size_, std::time_t time_);
+    std::string name;
+    DirectoryEntryKind kind;
+    uint64_t size;
+    std::time_t time;
+};
+
+// Reads the entries of a directory except '.' and '..' in one pass. Kind, size and last write time come from the directory listing itself.
+// Only symbolic links and other reparse points are resolved separately, so that they are reported as their targets.
+
+std::vector<DirectoryEntry> WING_API ReadDirectory(const std::string& directoryPath);
+
 } // wing
 
 #endif // WING_FILE_UTIL_INCLUDED
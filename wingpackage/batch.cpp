@@ -0,0 +1,197 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/batch.hpp>
+#include <wingpackage/path_matcher.hpp>
+#include <wingpackage/snapshot.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/environment.hpp>
+#include <wingpackage/links.hpp>
+#include <sngxml/dom/Parser.hpp>
+#include <soulng/util/Path.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+PackageBuild::PackageBuild() : byteCount(0), seconds(0), succeeded(false)
+{
+}
+
+PackageBuild::PackageBuild(const std::string& packageXmlFilePath_) : packageXmlFilePath(packageXmlFilePath_), byteCount(0), seconds(0), succeeded(false)
+{
+}
+
+int64_t PreviousPackageSize(const std::string& packageXmlFilePath)
+{
+    boost::system::error_code ec;
+    uintmax_t size = boost::filesystem::file_size(MakeNativeBoostPath(Path::ChangeExtension(packageXmlFilePath, ".bin")), ec);
+    if (ec)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(size);
+}
+
+// Each job runs its own scanner thread, so the budget holds the extra scanning threads that the jobs share.
+
+PackageBuilder::PackageBuilder(const std::vector<std::string>& packageXmlFilePaths, Content content_, bool useSnapshot_, bool verbose_, int numJobs_) :
+    content(content_), useSnapshot(useSnapshot_), verbose(verbose_), numJobs(std::max(1, std::min(numJobs_, static_cast<int>(packageXmlFilePaths.size())))),
+    observer(nullptr), threadBudget(DefaultScanThreadCount() - numJobs), nextBuild(0), seconds(0)
+{
+    std::vector<int64_t> previousSizes;
+    for (int i = 0; i < static_cast<int>(packageXmlFilePaths.size()); ++i)
+    {
+        builds.push_back(PackageBuild(packageXmlFilePaths[i]));
+        buildOrder.push_back(i);
+        previousSizes.push_back(PreviousPackageSize(packageXmlFilePaths[i]));
+    }
+    std::stable_sort(buildOrder.begin(), buildOrder.end(), [&previousSizes](int left, int right) { return previousSizes[left] > previousSizes[right]; });
+}
+
+void PackageBuilder::Run()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numJobs; ++i)
+    {
+        threads.push_back(std::thread([this] { RunJob(); }));
+    }
+    RunJob();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+}
+
+int PackageBuilder::FailedCount() const
+{
+    int failedCount = 0;
+    for (const PackageBuild& build : builds)
+    {
+        if (!build.succeeded)
+        {
+            ++failedCount;
+        }
+    }
+    return failedCount;
+}
+
+void PackageBuilder::RunJob()
+{
+    while (true)
+    {
+        int index = nextBuild++;
+        if (index >= static_cast<int>(buildOrder.size())) return;
+        PackageBuild& build = builds[buildOrder[index]];
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            Build(build);
+            build.succeeded = true;
+        }
+        catch (const std::exception& ex)
+        {
+            build.error = ex.what();
+            Log("creating package '" + build.packageXmlFilePath + "' failed: " + build.error);
+        }
+        auto end = std::chrono::steady_clock::now();
+        build.seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+    }
+}
+
+void PackageBuilder::Build(PackageBuild& build)
+{
+    const std::string& packageXmlFilePath = build.packageXmlFilePath;
+    Log("creating package '" + packageXmlFilePath + "'...");
+    std::unique_ptr<sngxml::dom::Document> packageDoc = sngxml::dom::ReadDocument(packageXmlFilePath, sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena | sngxml::dom::Flags::utf8);
+    PathMatcher pathMatcher(packageXmlFilePath);
+    pathMatcher.SetThreadBudget(&threadBudget);
+    std::unique_ptr<ScanSnapshot> snapshot;
+    if (useSnapshot)
+    {
+        snapshot.reset(new ScanSnapshot(packageXmlFilePath));
+        snapshot->Load();
+        pathMatcher.SetScanSnapshot(snapshot.get());
+    }
+    std::unique_ptr<Package> package(new Package(pathMatcher, packageDoc.get()));
+    if (snapshot)
+    {
+        Log(std::to_string(snapshot->ReusedCount()) + " of " + std::to_string(snapshot->DirectoryCount()) + " directories taken from scan snapshot");
+    }
+    std::string xmlIndexFilePath = Path::ChangeExtension(packageXmlFilePath, ".index.xml");
+    package->WriteIndexToXmlFile(xmlIndexFilePath);
+    Log("==> " + xmlIndexFilePath);
+    std::string packageBinFilePath = Path::ChangeExtension(packageXmlFilePath, ".bin");
+    if (observer && numJobs == 1)
+    {
+        package->AddObserver(observer);
+        package->Create(packageBinFilePath, content);
+        package->RemoveObserver(observer);
+    }
+    else
+    {
+        package->Create(packageBinFilePath, content);
+    }
+    Log("==> " + packageBinFilePath);
+    std::string xmlInfoFilePath = Path::ChangeExtension(packageXmlFilePath, ".info.xml");
+    package->WriteInfoXmlFile(xmlInfoFilePath);
+    Log("==> " + xmlInfoFilePath);
+    if (snapshot)
+    {
+        snapshot->Save();
+        Log("==> " + snapshot->FilePath());
+    }
+    build.byteCount = package->FileContentSize();
+}
+
+void PackageBuilder::Log(const std::string& line)
+{
+    if (!verbose) return;
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::cout << line << std::endl;
+}
+
+void PrintPackageBuildSummary(const PackageBuilder& builder, std::ostream& stream)
+{
+    int64_t byteCount = 0;
+    for (const PackageBuild& build : builder.Builds())
+    {
+        if (build.succeeded)
+        {
+            double megabytes = build.byteCount / (1024.0 * 1024.0);
+            double throughput = 0;
+            if (build.seconds > 0)
+            {
+                throughput = megabytes / build.seconds;
+            }
+            stream << "package '" << build.packageXmlFilePath << "': " << build.byteCount << " bytes in " << build.seconds <<
+                " seconds (" << throughput << " MB/s)" << std::endl;
+            byteCount += build.byteCount;
+        }
+        else
+        {
+            stream << "package '" << build.packageXmlFilePath << "': FAILED after " << build.seconds << " seconds: " << build.error << std::endl;
+        }
+    }
+    double megabytes = byteCount / (1024.0 * 1024.0);
+    double throughput = 0;
+    if (builder.Seconds() > 0)
+    {
+        throughput = megabytes / builder.Seconds();
+    }
+    stream << builder.Builds().size() - builder.FailedCount() << " of " << builder.Builds().size() << " packages created, " << byteCount << " bytes in " << builder.Seconds() <<
+        " seconds (" << throughput << " MB/s) using " << builder.NumJobs() << " jobs" << std::endl;
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,62 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_BATCH_INCLUDED
+#define WINGSTALL_WINGPACKAGE_BATCH_INCLUDED
+#include <wingpackage/package.hpp>
+#include <wingpackage/scanner.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace wingstall { namespace wingpackage {
+
+struct PackageBuild
+{
+    PackageBuild();
+    PackageBuild(const std::string& packageXmlFilePath_);
+    std::string packageXmlFilePath;
+    int64_t byteCount;
+    double seconds;
+    bool succeeded;
+    std::string error;
+};
+
+// Creates the package files of several packages using a given number of jobs. Each job takes the next package to build until all packages have been built.
+// Packages whose previous package file is largest are started first, so the largest package does not start last.
+// The scanners of all packages borrow their threads from a single thread budget. Writing a package is sequential, so each job writes one package at a time.
+// A failed package does not stop the other packages from being built.
+
+class PackageBuilder
+{
+public:
+    PackageBuilder(const std::vector<std::string>& packageXmlFilePaths, Content content_, bool useSnapshot_, bool verbose_, int numJobs_);
+    void SetObserver(PackageObserver* observer_) { observer = observer_; }
+    void Run();
+    const std::vector<PackageBuild>& Builds() const { return builds; }
+    int NumJobs() const { return numJobs; }
+    double Seconds() const { return seconds; }
+    int FailedCount() const;
+private:
+    void RunJob();
+    void Build(PackageBuild& build);
+    void Log(const std::string& line);
+    std::vector<PackageBuild> builds;
+    std::vector<int> buildOrder;
+    Content content;
+    bool useSnapshot;
+    bool verbose;
+    int numJobs;
+    PackageObserver* observer;
+    ThreadBudget threadBudget;
+    std::atomic<int> nextBuild;
+    std::mutex logMutex;
+    double seconds;
+};
+
+void PrintPackageBuildSummary(const PackageBuilder& builder, std::ostream& stream);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_BATCH_INCLUDED
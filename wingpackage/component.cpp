@@ -8,6 +8,7 @@
 #include <wingpackage/directory.hpp>
 #include <wingpackage/file.hpp>
 #include <wingpackage/path_matcher.hpp>
+#include <wingpackage/scanner.hpp>
 #include <sngxml/xpath/XPathEvaluate.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/TextUtils.hpp>
@@ -71,6 +72,7 @@ Component::Component(PathMatcher& pathMatcher, sngxml::dom::Element* element) :
         AddFile(file);
     }
     pathMatcher.EndFiles();
+    SourceScanner scanner(pathMatcher, DefaultScanThreadCount());
     std::unique_ptr<sngxml::xpath::XPathObject> directoryObject = sngxml::xpath::Evaluate(U"directory", element);
     if (directoryObject)
     {
@@ -87,9 +89,9 @@ Component::Component(PathMatcher& pathMatcher, sngxml::dom::Element* element) :
                     std::u32string nameAttr = element->GetAttribute(U"name");
                     if (!nameAttr.empty())
                     {
-                        std::time_t time = std::time_t();
-                        Directory* directory = new Directory(pathMatcher, ToUtf8(nameAttr), time, element);
+                        Directory* directory = new Directory(ToUtf8(nameAttr), std::time_t());
                         AddDirectory(directory);
+                        scanner.AddDirectory(directory, element);
                     }
                     else
                     {
@@ -100,6 +102,7 @@ Component::Component(PathMatcher& pathMatcher, sngxml::dom::Element* element) :
             }
         }
     }
+    scanner.Run();
 }
 
 void Component::RunCommands()
@@ -226,6 +229,18 @@ void Component::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void Component::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    for (const auto& directory : directories)
+    {
+        directory->VisitData(reader, visitor);
+    }
+    for (const auto& file : files)
+    {
+        file->VisitData(reader, visitor);
+    }
+}
+
 void Component::Uninstall()
 {
     Package* package = GetPackage();
@@ -245,21 +260,19 @@ void Component::Uninstall()
     }
 }
 
-sngxml::dom::Element* Component::ToXml() const
+void Component::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"component");
-    element->SetAttribute(U"name", ToUtf32(Name()));
+    writer.StartElement("component");
+    writer.Attribute("name", Name());
     for (const auto& directory : directories)
     {
-        sngxml::dom::Element* child = directory->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        directory->WriteXml(writer);
     }
     for (const auto& file : files)
     {
-        sngxml::dom::Element* child = file->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        file->WriteXml(writer);
     }
-    return element;
+    writer.EndElement();
 }
 
 } } // namespace wingstall::wingpackage
@@ -37,6 +37,7 @@ public:
     virtual void RemoveInstallationInfo();
     const std::vector<std::unique_ptr<Directory>>& Directories() const { return directories; }
     void AddDirectory(Directory* directory);
+    virtual const std::vector<std::unique_ptr<File>>& Files() const { return files; }
     void AddFile(File* file);
     virtual void Write(Streams& streams);
     virtual void Read(Streams& streams);
@@ -44,8 +45,9 @@ public:
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
     void Uninstall() override;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
 private:
     std::vector<std::unique_ptr<Directory>> directories;
     std::vector<std::unique_ptr<File>> files;
@@ -0,0 +1,34 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/data_visitor.hpp>
+#include <wingpackage/file.hpp>
+
+namespace wingstall { namespace wingpackage {
+
+DataVisitor::~DataVisitor()
+{
+}
+
+void SkipDataVisitor::VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash)
+{
+    SkipBytes(reader, file->Size());
+    if (hasHash)
+    {
+        reader.ReadUtf8String();
+    }
+}
+
+// In an uncompressed package file whole checksum frames are skipped by seeking past them. Compressed data is skipped by decompressing and discarding it.
+
+void SkipBytes(BinaryStreamReader& reader, int64_t count)
+{
+    if (reader.GetStream().Skip(count) != count)
+    {
+        throw std::runtime_error("unexpected end of package data stream");
+    }
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,38 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_DATA_VISITOR_INCLUDED
+#define WINGSTALL_WINGPACKAGE_DATA_VISITOR_INCLUDED
+#include <wingpackage/node.hpp>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+class File;
+
+// Visits the file contents of a package data stream in the order they were written by WriteData without installing anything.
+// The visitor must consume exactly file->Size() bytes, followed by the hash string if hasHash is true.
+// When Done() returns true, the rest of the data stream is left unread.
+
+class DataVisitor
+{
+public:
+    virtual ~DataVisitor();
+    virtual void VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash) = 0;
+    virtual bool Done() const { return false; }
+};
+
+class SkipDataVisitor : public DataVisitor
+{
+public:
+    void VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash) override;
+};
+
+void SkipBytes(BinaryStreamReader& reader, int64_t count);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_DATA_VISITOR_INCLUDED
@@ -0,0 +1,135 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/diff.hpp>
+#include <soulng/util/Time.hpp>
+#include <unordered_map>
+#include <cmath>
+#include <ctime>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+std::string DiffKindStr(DiffKind kind)
+{
+    switch (kind)
+    {
+        case DiffKind::added: return "added";
+        case DiffKind::removed: return "removed";
+        case DiffKind::modified: return "modified";
+        case DiffKind::metadataChanged: return "metadata";
+    }
+    return std::string();
+}
+
+DiffEntry::DiffEntry(DiffKind kind_, const IndexEntry* left_, const IndexEntry* right_) : kind(kind_), left(left_), right(right_)
+{
+}
+
+PackageIndexDiff::PackageIndexDiff() :
+    addedCount(0), addedBytes(0), removedCount(0), removedBytes(0), modifiedCount(0), modifiedOldBytes(0), modifiedNewBytes(0), metadataChangedCount(0)
+{
+}
+
+// Index XML files store local times without an offset. A local time in the hour when daylight saving time ends occurs twice, so reading it back may give
+// a time one hour off. Such a difference alone does not count as a change when the hashes show that the content is the same.
+
+bool IsDaylightSavingTimeShift(std::time_t leftTime, std::time_t rightTime)
+{
+    return std::abs(std::difftime(leftTime, rightTime)) == 3600.0;
+}
+
+PackageIndexDiff DiffIndexEntries(const std::vector<IndexEntry>& left, const std::vector<IndexEntry>& right)
+{
+    PackageIndexDiff diff;
+    std::unordered_map<std::string, const IndexEntry*> leftMap;
+    leftMap.reserve(left.size());
+    for (const IndexEntry& entry : left)
+    {
+        leftMap[entry.path] = &entry;
+    }
+    for (const IndexEntry& rightEntry : right)
+    {
+        auto it = leftMap.find(rightEntry.path);
+        if (it == leftMap.cend())
+        {
+            diff.entries.push_back(DiffEntry(DiffKind::added, nullptr, &rightEntry));
+            ++diff.addedCount;
+            diff.addedBytes += rightEntry.size;
+        }
+        else
+        {
+            const IndexEntry* leftEntry = it->second;
+            leftMap.erase(it);
+            bool hashesKnown = !leftEntry->hash.empty() && !rightEntry.hash.empty();
+            bool contentChanged = leftEntry->size != rightEntry.size || (hashesKnown && leftEntry->hash != rightEntry.hash);
+            bool timeChanged = leftEntry->time != rightEntry.time && !(hashesKnown && IsDaylightSavingTimeShift(leftEntry->time, rightEntry.time));
+            if (contentChanged || (timeChanged && !hashesKnown))
+            {
+                diff.entries.push_back(DiffEntry(DiffKind::modified, leftEntry, &rightEntry));
+                ++diff.modifiedCount;
+                diff.modifiedOldBytes += leftEntry->size;
+                diff.modifiedNewBytes += rightEntry.size;
+            }
+            else if (timeChanged || leftEntry->component != rightEntry.component)
+            {
+                diff.entries.push_back(DiffEntry(DiffKind::metadataChanged, leftEntry, &rightEntry));
+                ++diff.metadataChangedCount;
+            }
+        }
+    }
+    for (const IndexEntry& leftEntry : left)
+    {
+        if (leftMap.find(leftEntry.path) != leftMap.cend())
+        {
+            diff.entries.push_back(DiffEntry(DiffKind::removed, &leftEntry, nullptr));
+            ++diff.removedCount;
+            diff.removedBytes += leftEntry.size;
+        }
+    }
+    return diff;
+}
+
+void PrintPackageIndexDiff(const PackageIndexDiff& diff, std::ostream& stream)
+{
+    for (const DiffEntry& entry : diff.entries)
+    {
+        switch (entry.kind)
+        {
+            case DiffKind::added:
+            {
+                stream << "added    " << entry.right->path << " (" << entry.right->size << " bytes)" << std::endl;
+                break;
+            }
+            case DiffKind::removed:
+            {
+                stream << "removed  " << entry.left->path << " (" << entry.left->size << " bytes)" << std::endl;
+                break;
+            }
+            case DiffKind::modified:
+            {
+                stream << "modified " << entry.right->path << " (" << entry.left->size << " -> " << entry.right->size << " bytes)" << std::endl;
+                break;
+            }
+            case DiffKind::metadataChanged:
+            {
+                stream << "metadata " << entry.right->path << " (" << TimeToString(entry.left->time) << " -> " << TimeToString(entry.right->time);
+                if (entry.left->component != entry.right->component)
+                {
+                    stream << ", component '" << entry.left->component << "' -> '" << entry.right->component << "'";
+                }
+                stream << ")" << std::endl;
+                break;
+            }
+        }
+    }
+    stream << diff.addedCount << " added (" << diff.addedBytes << " bytes), " <<
+        diff.removedCount << " removed (" << diff.removedBytes << " bytes), " <<
+        diff.modifiedCount << " modified (" << diff.modifiedOldBytes << " -> " << diff.modifiedNewBytes << " bytes), " <<
+        diff.metadataChangedCount << " metadata only" << std::endl;
+}
+
+} } // namespace wingstall::wingpackage
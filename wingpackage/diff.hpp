@@ -0,0 +1,49 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_DIFF_INCLUDED
+#define WINGSTALL_WINGPACKAGE_DIFF_INCLUDED
+#include <wingpackage/query.hpp>
+
+namespace wingstall { namespace wingpackage {
+
+enum class DiffKind
+{
+    added, removed, modified, metadataChanged
+};
+
+std::string DiffKindStr(DiffKind kind);
+
+struct DiffEntry
+{
+    DiffEntry(DiffKind kind_, const IndexEntry* left_, const IndexEntry* right_);
+    DiffKind kind;
+    const IndexEntry* left;
+    const IndexEntry* right;
+};
+
+struct PackageIndexDiff
+{
+    PackageIndexDiff();
+    std::vector<DiffEntry> entries;
+    int64_t addedCount;
+    int64_t addedBytes;
+    int64_t removedCount;
+    int64_t removedBytes;
+    int64_t modifiedCount;
+    int64_t modifiedOldBytes;
+    int64_t modifiedNewBytes;
+    int64_t metadataChangedCount;
+};
+
+// Joins the entries on path. File content is considered modified if the sizes differ or if both sides have a hash and the hashes differ.
+// If either side lacks a hash (index written before package data), a changed time is also reported as a modification.
+
+PackageIndexDiff DiffIndexEntries(const std::vector<IndexEntry>& left, const std::vector<IndexEntry>& right);
+void PrintPackageIndexDiff(const PackageIndexDiff& diff, std::ostream& stream);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_DIFF_INCLUDED
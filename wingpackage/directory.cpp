@@ -6,7 +6,6 @@
 #include <wingpackage/directory.hpp>
 #include <wingpackage/package.hpp>
 #include <wingpackage/file.hpp>
-#include <wingpackage/path_matcher.hpp>
 #include <soulng/util/Unicode.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/TextUtils.hpp>
@@ -25,39 +24,8 @@ Directory::Directory(const std::string& name_) : Node(NodeKind::directory, name_
 {
 }
 
-Directory::Directory(PathMatcher& pathMatcher, const std::string& name, std::time_t time_, sngxml::dom::Element* element) : Node(NodeKind::directory), time(time_), flags(DirectoryFlags::none)
+Directory::Directory(const std::string& name_, std::time_t time_) : Node(NodeKind::directory, name_), time(time_), flags(DirectoryFlags::none)
 {
-    if (name.empty())
-    {
-        std::string lineColStr;
-        if (element)
-        {
-            lineColStr = " line " + std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col);
-        }
-        throw std::runtime_error("directory element has no 'name' attribute in package XML document '" + pathMatcher.XmlFilePath() + "'" + lineColStr);
-    }
-    SetName(name);
-    pathMatcher.BeginDirectory(Name(), element);
-    if (time == std::time_t())
-    {
-        time = boost::filesystem::last_write_time(MakeNativeBoostPath(pathMatcher.CurrentDir()));
-    }
-    std::vector<DirectoryInfo> directories = pathMatcher.Directories();
-    for (const auto& directoryInfo : directories)
-    {
-        Directory* directory = new Directory(pathMatcher, directoryInfo.name, directoryInfo.time, directoryInfo.element);
-        AddDirectory(directory);
-    }
-    std::vector<FileInfo> files = pathMatcher.Files();
-    for (const auto& fileInfo : files)
-    {
-        File* file = new File();
-        file->SetName(fileInfo.name);
-        file->SetSize(fileInfo.size);
-        file->SetTime(fileInfo.time);
-        AddFile(file);
-    }
-    pathMatcher.EndDirectory();
 }
 
 void Directory::AddDirectory(Directory* directory)
@@ -66,12 +34,26 @@ void Directory::AddDirectory(Directory* directory)
     directories.push_back(std::unique_ptr<Directory>(directory));
 }
 
+std::vector<std::unique_ptr<Directory>> Directory::ReleaseDirectories()
+{
+    std::vector<std::unique_ptr<Directory>> released;
+    std::swap(released, directories);
+    return released;
+}
+
 void Directory::AddFile(File* file)
 {
     file->SetParent(this);
     files.push_back(std::unique_ptr<File>(file));
 }
 
+std::vector<std::unique_ptr<File>> Directory::ReleaseFiles()
+{
+    std::vector<std::unique_ptr<File>> released;
+    std::swap(released, files);
+    return released;
+}
+
 void Directory::WriteIndex(BinaryStreamWriter& writer)
 {
     Node::WriteIndex(writer);
@@ -133,6 +115,19 @@ int Directory::Level() const
     }
 }
 
+// Resolved once for each root and kept until the directory is resolved against another root: create resolves against the source root directory,
+// install and uninstall against the target root directory. Not safe to call concurrently for the same directory.
+
+const std::string& Directory::ResolvedPath(const std::string& root) const
+{
+    if (resolvedPath.empty() || resolvedRoot != root)
+    {
+        resolvedPath = Node::Path(root);
+        resolvedRoot = root;
+    }
+    return resolvedPath;
+}
+
 void Directory::SetFlag(DirectoryFlags flag, bool value)
 {
     if (value) flags = flags | flag;
@@ -164,7 +159,7 @@ void Directory::ReadData(BinaryStreamReader& reader)
         package->SetComponent(this);
         package->CheckInterrupted();
     }
-    std::string directoryPath = Path(GetTargetRootDir());
+    std::string directoryPath = ResolvedPath(GetTargetRootDir());
     bool exists = boost::filesystem::exists(MakeNativeBoostPath(directoryPath));
     SetFlag(DirectoryFlags::exists, exists);
     boost::system::error_code ec;
@@ -191,6 +186,18 @@ void Directory::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void Directory::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    for (const auto& directory : directories)
+    {
+        directory->VisitData(reader, visitor);
+    }
+    for (const auto& file : files)
+    {
+        file->VisitData(reader, visitor);
+    }
+}
+
 bool Directory::HasDirectoriesOrFiles() 
 {
     Package* package = GetPackage();
@@ -198,7 +205,7 @@ bool Directory::HasDirectoriesOrFiles()
     {
         try
         {
-            std::string directoryPath = Path(GetTargetRootDir());
+            std::string directoryPath = ResolvedPath(GetTargetRootDir());
             if (boost::filesystem::exists(MakeNativeBoostPath(directoryPath)))
             {
                 boost::system::error_code ec;
@@ -248,7 +255,7 @@ void Directory::Remove()
     {
         try
         {
-            std::string directoryPath = Path(GetTargetRootDir());
+            std::string directoryPath = ResolvedPath(GetTargetRootDir());
             boost::system::error_code ec;
             boost::filesystem::remove(MakeNativeBoostPath(directoryPath), ec);
             if (ec)
@@ -290,22 +297,20 @@ void Directory::Uninstall()
     }
 }
 
-sngxml::dom::Element* Directory::ToXml() const
+void Directory::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"directory");
-    element->SetAttribute(U"name", ToUtf32(Name()));
-    element->SetAttribute(U"time", ToUtf32(TimeToString(time)));
+    writer.StartElement("directory");
+    writer.Attribute("name", Name());
+    writer.Attribute("time", TimeToString(time));
     for (const auto& directory : directories)
     {
-        sngxml::dom::Element* child = directory->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        directory->WriteXml(writer);
     }
     for (const auto& file : files)
     {
-        sngxml::dom::Element* child = file->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        file->WriteXml(writer);
     }
-    return element;
+    writer.EndElement();
 }
 
 } } // namespace wingstall::wingpackage
\ No newline at end of file
@@ -13,7 +13,6 @@ namespace wingstall { namespace wingpackage {
 using namespace soulng::util;
 
 class File;
-class PathMatcher;
 
 enum class DirectoryFlags : uint8_t
 {
@@ -40,29 +39,37 @@ class Directory : public Node
 public:
     Directory();
     Directory(const std::string& name_);
-    Directory(PathMatcher& pathMatcher, const std::string& name, std::time_t time_, sngxml::dom::Element* element);
+    Directory(const std::string& name_, std::time_t time_);
     int Level() const;
+    const std::string& ResolvedPath(const std::string& root) const;
+    std::time_t Time() const { return time; }
+    void SetTime(std::time_t time_) { time = time_; }
     DirectoryFlags Flags() const { return flags; }
     void SetFlags(DirectoryFlags flags_) { flags = flags_; }
     void SetFlag(DirectoryFlags flag, bool value);
     bool GetFlag(DirectoryFlags flag) const { return (flags & flag) != DirectoryFlags::none; }
     const std::vector<std::unique_ptr<Directory>>& Directories() const { return directories; }
     void AddDirectory(Directory* directory);
+    std::vector<std::unique_ptr<Directory>> ReleaseDirectories();
     const std::vector<std::unique_ptr<File>>& Files() const { return files; }
     void AddFile(File* file);
+    std::vector<std::unique_ptr<File>> ReleaseFiles();
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
     bool HasDirectoriesOrFiles();
     void Remove();
     void Uninstall() override;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
 private:
     std::time_t time;
     DirectoryFlags flags;
     std::vector<std::unique_ptr<Directory>> directories;
     std::vector<std::unique_ptr<File>> files;
+    mutable std::string resolvedRoot;
+    mutable std::string resolvedPath;
 };
 
 } } // namespace wingstall::wingpackage
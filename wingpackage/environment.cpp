@@ -47,13 +47,13 @@ EnvironmentVariable::EnvironmentVariable(PathMatcher& pathMatcher, sngxml::dom::
     }
 }
 
-sngxml::dom::Element* EnvironmentVariable::ToXml() const
+void EnvironmentVariable::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"variable");
-    element->SetAttribute(U"name", ToUtf32(Name()));
-    element->SetAttribute(U"value", ToUtf32(value));
-    element->SetAttribute(U"oldValue", ToUtf32(oldValue));
-    return element;
+    writer.StartElement("variable");
+    writer.Attribute("name", Name());
+    writer.Attribute("value", value);
+    writer.Attribute("oldValue", oldValue);
+    writer.EndElement();
 }
 
 void EnvironmentVariable::SetFlag(EnvironmentVariableFlags flag, bool value)
@@ -196,11 +196,11 @@ PathDirectory::PathDirectory(PathMatcher& pathMatcher, sngxml::dom::Element* ele
     }
 }
 
-sngxml::dom::Element* PathDirectory::ToXml() const
+void PathDirectory::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"pathDirectory");
-    element->SetAttribute(U"value", ToUtf32(value));
-    return element;
+    writer.StartElement("pathDirectory");
+    writer.Attribute("value", value);
+    writer.EndElement();
 }
 
 void PathDirectory::WriteIndex(BinaryStreamWriter& writer)
@@ -383,20 +383,18 @@ void Environment::ReadIndex(BinaryStreamReader& reader)
     }
 }
 
-sngxml::dom::Element* Environment::ToXml() const
+void Environment::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"environment");
+    writer.StartElement("environment");
     for (const auto& variable : variables)
     {
-        sngxml::dom::Element* child = variable->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        variable->WriteXml(writer);
     }
     for (const auto& pathDirectory : pathDirectories)
     {
-        sngxml::dom::Element* child = pathDirectory->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        pathDirectory->WriteXml(writer);
     }
-    return element;
+    writer.EndElement();
 }
 
 void Environment::Install()
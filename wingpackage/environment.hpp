@@ -43,7 +43,7 @@ public:
     bool GetFlag(EnvironmentVariableFlags flag) const { return (flags & flag) != EnvironmentVariableFlags::none; }
     const std::string& Value() const { return value; }
     void SetValue(const std::string& value_) { value = value_; }
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void SetOldValue();
@@ -88,7 +88,7 @@ public:
     void SetFlags(PathDirectoryFlags flags_) { flags = flags_; }
     void SetFlag(PathDirectoryFlags flag, bool value);
     bool GetFlag(PathDirectoryFlags flag) const { return (flags & flag) != PathDirectoryFlags::none; }
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void Install();
@@ -107,7 +107,7 @@ public:
     Environment(PathMatcher& pathMatcher, sngxml::dom::Element* element);
     void AddVariable(EnvironmentVariable* variable);
     void AddPathDirectory(PathDirectory* pathDirectory);
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void Install();
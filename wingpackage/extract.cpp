@@ -0,0 +1,158 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/extract.hpp>
+#include <wingpackage/component.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/environment.hpp>
+#include <wingpackage/links.hpp>
+#include <soulng/util/BufferedStream.hpp>
+#include <soulng/util/FileStream.hpp>
+#include <soulng/util/Path.hpp>
+#include <soulng/util/TextUtils.hpp>
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+namespace wingstall { namespace wingpackage {
+
+ExtractDataVisitor::ExtractDataVisitor(const std::set<File*>& filesToExtract_, const std::string& targetDir_, bool verbose_) :
+    filesToExtract(filesToExtract_), targetDir(targetDir_), verbose(verbose_), extractedCount(0), extractedBytes(0)
+{
+}
+
+// Returns the full path of a package file under the target directory. The path of the file comes from the package, so a path that is absolute or whose '..' components
+// lead out of the target directory is rejected.
+
+std::string GetTargetFilePath(const std::string& targetDir, const std::string& path)
+{
+    std::string fullTargetDir = GetFullPath(targetDir);
+    if (fullTargetDir.empty() || fullTargetDir.back() != '/')
+    {
+        fullTargetDir.append(1, '/');
+    }
+    std::string filePath = GetFullPath(Path::Combine(fullTargetDir, path));
+    if (filePath.length() <= fullTargetDir.length() || filePath.substr(0, fullTargetDir.length()) != fullTargetDir)
+    {
+        throw std::runtime_error("path '" + path + "' of a package file is not under target directory '" + fullTargetDir + "'");
+    }
+    return filePath;
+}
+
+void ExtractDataVisitor::VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash)
+{
+    if (filesToExtract.find(file) == filesToExtract.cend())
+    {
+        SkipBytes(reader, file->Size());
+        if (hasHash)
+        {
+            reader.ReadUtf8String();
+        }
+        return;
+    }
+    std::string filePath = GetTargetFilePath(targetDir, file->Path());
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(MakeNativeBoostPath(Path::GetDirectoryName(filePath)), ec);
+    if (ec)
+    {
+        throw std::runtime_error("could not create directory '" + Path::GetDirectoryName(filePath) + "': " + PlatformStringToUtf8(ec.message()));
+    }
+    {
+        FileStream fileStream(filePath, OpenMode::write | OpenMode::binary);
+        BufferedStream bufferedStream(fileStream);
+        Stream& stream = reader.GetStream();
+        uint8_t buf[4096];
+        int64_t count = file->Size();
+        while (count > 0)
+        {
+            int64_t n = stream.Read(buf, std::min(count, static_cast<int64_t>(sizeof(buf))));
+            if (n <= 0)
+            {
+                throw std::runtime_error("unexpected end of package data stream while extracting file '" + file->Path() + "'");
+            }
+            bufferedStream.Write(buf, n);
+            count -= n;
+        }
+    }
+    if (hasHash)
+    {
+        reader.ReadUtf8String();
+    }
+    boost::filesystem::last_write_time(MakeNativeBoostPath(filePath), file->Time(), ec);
+    if (ec)
+    {
+        throw std::runtime_error("could not set write time of file '" + filePath + "': " + PlatformStringToUtf8(ec.message()));
+    }
+    ++extractedCount;
+    extractedBytes += file->Size();
+    if (verbose)
+    {
+        std::cout << "==> " << filePath << std::endl;
+    }
+}
+
+void AddFilesToExtract(Directory* directory, IndexFilter& filter, std::set<File*>& filesToExtract)
+{
+    for (const auto& childDirectory : directory->Directories())
+    {
+        AddFilesToExtract(childDirectory.get(), filter, filesToExtract);
+    }
+    for (const auto& file : directory->Files())
+    {
+        if (filter.IncludePath(file->Path()))
+        {
+            filesToExtract.insert(file.get());
+        }
+    }
+}
+
+std::set<File*> GetFilesToExtract(Package* package, IndexFilter& filter)
+{
+    std::set<File*> filesToExtract;
+    for (const auto& component : package->Components())
+    {
+        if (!filter.IncludeComponent(component->Name())) continue;
+        for (const auto& directory : component->Directories())
+        {
+            AddFilesToExtract(directory.get(), filter, filesToExtract);
+        }
+        for (const auto& file : component->Files())
+        {
+            if (filter.IncludePath(file->Path()))
+            {
+                filesToExtract.insert(file.get());
+            }
+        }
+    }
+    return filesToExtract;
+}
+
+int64_t ExtractPackageFiles(const std::string& packageFilePath, IndexFilter& filter, const std::string& targetDir, Content content, bool verbose)
+{
+    if ((content & Content::data) == Content::none)
+    {
+        throw std::runtime_error("package content does not include data");
+    }
+    std::unique_ptr<Package> package(new Package());
+    Streams streams = package->ReadPackageIndex(DataSource::file, packageFilePath, nullptr, 0, content);
+    std::set<File*> filesToExtract = GetFilesToExtract(package.get(), filter);
+    ExtractDataVisitor visitor(filesToExtract, targetDir, verbose);
+    if (!filesToExtract.empty())
+    {
+        BinaryStreamReader reader(streams.Back());
+        package->VisitData(reader, visitor);
+    }
+    if (visitor.ExtractedCount() != filesToExtract.size())
+    {
+        throw std::runtime_error("package '" + packageFilePath + "' ended before all files were extracted");
+    }
+    if (verbose)
+    {
+        std::cout << visitor.ExtractedCount() << " files (" << visitor.ExtractedBytes() << " bytes) extracted from package '" << packageFilePath << "'" << std::endl;
+    }
+    return visitor.ExtractedCount();
+}
+
+} } // namespace wingstall::wingpackage
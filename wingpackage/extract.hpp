@@ -0,0 +1,41 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_EXTRACT_INCLUDED
+#define WINGSTALL_WINGPACKAGE_EXTRACT_INCLUDED
+#include <wingpackage/data_visitor.hpp>
+#include <wingpackage/package.hpp>
+#include <wingpackage/query.hpp>
+#include <set>
+
+namespace wingstall { namespace wingpackage {
+
+class ExtractDataVisitor : public DataVisitor
+{
+public:
+    ExtractDataVisitor(const std::set<File*>& filesToExtract_, const std::string& targetDir_, bool verbose_);
+    void VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash) override;
+    bool Done() const override { return extractedCount == filesToExtract.size(); }
+    int64_t ExtractedCount() const { return extractedCount; }
+    int64_t ExtractedBytes() const { return extractedBytes; }
+private:
+    const std::set<File*>& filesToExtract;
+    std::string targetDir;
+    bool verbose;
+    int64_t extractedCount;
+    int64_t extractedBytes;
+};
+
+std::set<File*> GetFilesToExtract(Package* package, IndexFilter& filter);
+
+// Extracts files of a package matching the filter to a target directory.
+// Data of the other files is skipped: seeked over in an uncompressed package, otherwise decompressed without writing.
+// Reading stops after the last matching file.
+
+int64_t ExtractPackageFiles(const std::string& packageFilePath, IndexFilter& filter, const std::string& targetDir, Content content, bool verbose);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_EXTRACT_INCLUDED
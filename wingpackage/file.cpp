@@ -5,6 +5,7 @@
 
 #include <wingpackage/file.hpp>
 #include <wingpackage/package.hpp>
+#include <wingpackage/data_visitor.hpp>
 #include <soulng/util/BinaryReader.hpp>
 #include <soulng/util/FileStream.hpp>
 #include <soulng/util/BufferedStream.hpp>
@@ -74,6 +75,12 @@ void File::WriteData(BinaryStreamWriter& writer)
     Sha1 sha1;
     std::string filePath = Path(GetSourceRootDir());
     FileStream fileStream(filePath, OpenMode::read | OpenMode::binary);
+    int64_t fileSize = fileStream.Size();
+    if (fileSize != static_cast<int64_t>(size))
+    {
+        throw std::runtime_error("size of file '" + filePath + "' has changed after it was scanned: expected " + std::to_string(size) + " bytes, file has " +
+            std::to_string(fileSize) + " bytes");
+    }
     BufferedStream bufferedStream(fileStream);
     int64_t n = size;
     for (int64_t i = 0; i < n; ++i)
@@ -132,6 +139,12 @@ void File::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void File::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    if (visitor.Done()) return;
+    visitor.VisitFileData(this, reader, true);
+}
+
 std::string File::ComputeHash() const
 {
     std::string filePath = Path(GetTargetRootDir());
@@ -230,14 +243,14 @@ void File::Uninstall()
     }
 }
 
-sngxml::dom::Element* File::ToXml() const
+void File::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"file");
-    element->SetAttribute(U"name", ToUtf32(Name()));
-    element->SetAttribute(U"size", ToUtf32(std::to_string(size)));
-    element->SetAttribute(U"time", ToUtf32(TimeToString(time)));
-    element->SetAttribute(U"hash", ToUtf32(hash));
-    return element;
+    writer.StartElement("file");
+    writer.Attribute("name", Name());
+    writer.Attribute("size", std::to_string(size));
+    writer.Attribute("time", TimeToString(time));
+    writer.Attribute("hash", hash);
+    writer.EndElement();
 }
 
 } } // namespace wingstall::wingpackage
@@ -54,9 +54,10 @@ public:
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
     void Remove();
     void Uninstall() override;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
 private:
     uintmax_t size;
     std::time_t time;
@@ -129,17 +129,17 @@ void Link::ReadIndex(BinaryStreamReader& reader)
     }
 }
 
-sngxml::dom::Element* Link::ToXml() const
+void Link::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"link");
-    element->SetAttribute(U"linkFilePath", ToUtf32(linkFilePath));
-    element->SetAttribute(U"path", ToUtf32(path));
-    element->SetAttribute(U"arguments", ToUtf32(arguments));
-    element->SetAttribute(U"workingDirecory", ToUtf32(workingDirectory));
-    element->SetAttribute(U"description", ToUtf32(description));
-    element->SetAttribute(U"iconPath", ToUtf32(iconPath));
-    element->SetAttribute(U"iconIndex", ToUtf32(std::to_string(iconIndex)));
-    return element;
+    writer.StartElement("link");
+    writer.Attribute("linkFilePath", linkFilePath);
+    writer.Attribute("path", path);
+    writer.Attribute("arguments", arguments);
+    writer.Attribute("workingDirecory", workingDirectory);
+    writer.Attribute("description", description);
+    writer.Attribute("iconPath", iconPath);
+    writer.Attribute("iconIndex", std::to_string(iconIndex));
+    writer.EndElement();
 }
 
 void Link::Create(const std::string& expandedLinkFilePath, const std::string& expandedPath, const std::string& expandedWorkingDirectory, const std::string& expandedIconPath)
@@ -284,11 +284,11 @@ void LinkDirectory::ReadIndex(BinaryStreamReader& reader)
     flags = static_cast<LinkDirectoryFlags>(reader.ReadByte());
 }
 
-sngxml::dom::Element* LinkDirectory::ToXml() const
+void LinkDirectory::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"linkDirectory");
-    element->SetAttribute(U"path", ToUtf32(path));
-    return element;
+    writer.StartElement("linkDirectory");
+    writer.Attribute("path", path);
+    writer.EndElement();
 }
 
 void LinkDirectory::SetFlag(LinkDirectoryFlags flag, bool value)
@@ -425,20 +425,18 @@ void Links::AddLink(Link* link)
     links.push_back(std::unique_ptr<Link>(link));
 }
 
-sngxml::dom::Element* Links::ToXml() const
+void Links::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"links");
+    writer.StartElement("links");
     for (const auto& linkDirectory : linkDirectories)
     {
-        sngxml::dom::Element* child = linkDirectory->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        linkDirectory->WriteXml(writer);
     }
     for (const auto& link : links)
     {
-        sngxml::dom::Element* child = link->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        link->WriteXml(writer);
     }
-    return element;
+    writer.EndElement();
 }
 
 void Links::WriteIndex(BinaryStreamWriter& writer)
@@ -21,7 +21,7 @@ public:
     void SetOld(Link* old_);
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void Create(const std::string& expandedLinkFilePath, const std::string& expandedPath, const std::string& expandedWorkingDirectory, const std::string& expandedIconPath);
     void Install();
     void Uninstall() override;
@@ -79,7 +79,7 @@ public:
     bool GetFlag(LinkDirectoryFlags flag) const { return (flags & flag) != LinkDirectoryFlags::none; }
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void Create();
     void Remove();
     void Install();
@@ -99,7 +99,7 @@ public:
     Links(PathMatcher& pathMatcher, sngxml::dom::Element* element);
     void AddLinkDirectory(LinkDirectory* linkDirectory);
     void AddLink(Link* link);
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
     void WriteIndex(BinaryStreamWriter& writer);
     void ReadIndex(BinaryStreamReader& reader);
     void Install();
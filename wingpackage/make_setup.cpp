@@ -36,18 +36,18 @@ void CoutLogger::WriteLine(const std::string& line)
     std::cout << line << std::endl;
 }
 
+// The configuration settings are shared by these functions, so the configuration document is read once rather than once per setting.
+
 std::string BoostIncludeDir()
 {
     try
     {
-        std::unique_ptr<sngxml::dom::Document> configDoc = wingstall::config::ConfigurationDocument();
-        if (configDoc)
+        std::shared_ptr<const wingstall::config::ConfigurationSettings> settings = wingstall::config::GetConfigurationSettings();
+        if (settings)
         {
-            sngxml::dom::Element* rootElement = configDoc->DocumentElement();
-            std::u32string boostIncludeDirAttr = rootElement->GetAttribute(U"boostIncludeDir");
-            if (!boostIncludeDirAttr.empty())
+            if (!settings->boostIncludeDir.empty())
             {
-                return ToUtf8(boostIncludeDirAttr);
+                return settings->boostIncludeDir;
             }
             throw std::runtime_error("'boostIncludeDir' attribute is empty or does not exist");
         }
@@ -63,14 +63,12 @@ std::string BoostLibDir()
 {
     try
     {
-        std::unique_ptr<sngxml::dom::Document> configDoc = wingstall::config::ConfigurationDocument();
-        if (configDoc)
+        std::shared_ptr<const wingstall::config::ConfigurationSettings> settings = wingstall::config::GetConfigurationSettings();
+        if (settings)
         {
-            sngxml::dom::Element* rootElement = configDoc->DocumentElement();
-            std::u32string boosLibDirAttr = rootElement->GetAttribute(U"boostLibDir");
-            if (!boosLibDirAttr.empty())
+            if (!settings->boostLibDir.empty())
             {
-                return ToUtf8(boosLibDirAttr);
+                return settings->boostLibDir;
             }
             throw std::runtime_error("'boostLibDir' attribute is empty or does not exist");
         }
@@ -86,14 +84,12 @@ std::string VCPlatformToolset()
 {
     try
     {
-        std::unique_ptr<sngxml::dom::Document> configDoc = wingstall::config::ConfigurationDocument();
-        if (configDoc)
+        std::shared_ptr<const wingstall::config::ConfigurationSettings> settings = wingstall::config::GetConfigurationSettings();
+        if (settings)
         {
-            sngxml::dom::Element* rootElement = configDoc->DocumentElement();
-            std::u32string vcPlatformToolsetAttr = rootElement->GetAttribute(U"vcPlatformToolset");
-            if (!vcPlatformToolsetAttr.empty())
+            if (!settings->vcPlatformToolset.empty())
             {
-                return ToUtf8(vcPlatformToolsetAttr);
+                return settings->vcPlatformToolset;
             }
             throw std::runtime_error("'vcPlatformToolset' attribute is empty or does not exist");
         }
@@ -130,7 +126,7 @@ void MakeSetup(const std::string& packageBinFilePath, bool verbose, Logger* logg
     {
         logger->WriteLine("> " + packageInfoFilePath);
     }
-    std::unique_ptr<sngxml::dom::Document> packageInfoDoc = sngxml::dom::ReadDocument(packageInfoFilePath);
+    std::unique_ptr<sngxml::dom::Document> packageInfoDoc = sngxml::dom::ReadDocument(packageInfoFilePath, sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena);
     std::unique_ptr<sngxml::xpath::XPathObject> packageInfoObject = sngxml::xpath::Evaluate(U"/packageInfo", packageInfoDoc.get());
     if (packageInfoObject)
     {
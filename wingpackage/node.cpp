@@ -65,8 +65,18 @@ std::string Node::Path() const
     return path;
 }
 
+// The path of a node under a directory is the resolved path of the directory plus the name of the node, so resolving the path of a file takes a single append.
+
 std::string Node::Path(const std::string& root) const
 {
+    if (parent && parent->Kind() == NodeKind::directory)
+    {
+        const std::string& parentPath = static_cast<const Directory*>(parent)->ResolvedPath(root);
+        std::string path;
+        path.reserve(parentPath.length() + 1 + name.length());
+        path.append(parentPath).append(1, '/').append(name);
+        return path;
+    }
     std::string path(root);
     if (!path.empty() && path.back() != '/')
     {
@@ -126,6 +136,10 @@ void Node::ReadData(BinaryStreamReader& reader)
 {
 }
 
+void Node::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+}
+
 void Node::Uninstall()
 {
 }
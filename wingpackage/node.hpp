@@ -7,6 +7,7 @@
 #define WINGSTALL_WINGPACKAGE_NODE_INCLUDED
 #include <wingpackage/api.hpp>
 #include <sngxml/dom/Element.hpp>
+#include <sngxml/xml/XmlWriter.hpp>
 #include <soulng/util/BinaryStreamWriter.hpp>
 #include <soulng/util/BinaryStreamReader.hpp>
 #include <memory>
@@ -27,6 +28,7 @@ class Directory;
 class File;
 
 class Package;
+class DataVisitor;
 
 class Node
 {
@@ -49,8 +51,9 @@ public:
     virtual void ReadIndex(BinaryStreamReader& reader);
     virtual void WriteData(BinaryStreamWriter& writer);
     virtual void ReadData(BinaryStreamReader& reader);
+    virtual void VisitData(BinaryStreamReader& reader, DataVisitor& visitor);
     virtual void Uninstall();
-    virtual sngxml::dom::Element* ToXml() const = 0;
+    virtual void WriteXml(sngxml::xml::XmlWriter& writer) const = 0;
 private:
     NodeKind kind;
     std::string name;
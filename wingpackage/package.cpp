@@ -14,11 +14,11 @@
 #include <wingpackage/links.hpp>
 #include <sngxml/xpath/XPathEvaluate.hpp>
 #include <sngxml/dom/Element.hpp>
-#include <soulng/util/CodeFormatter.hpp>
 #include <soulng/util/BinaryStreamWriter.hpp>
 #include <soulng/util/BinaryStreamReader.hpp>
 #include <soulng/util/BZip2Stream.hpp>
 #include <soulng/util/BufferedStream.hpp>
+#include <soulng/util/ChecksumFrameStream.hpp>
 #include <soulng/util/DeflateStream.hpp>
 #include <soulng/util/FileStream.hpp>
 #include <soulng/util/MemoryStream.hpp>
@@ -91,20 +91,20 @@ Package::Package(PathMatcher& pathMatcher, sngxml::dom::Document* doc) :
                 if (node->GetNodeType() == sngxml::dom::NodeType::elementNode)
                 {
                     sngxml::dom::Element* element = static_cast<sngxml::dom::Element*>(node);
-                    std::u32string nameAttr = element->GetAttribute(U"name");
+                    std::string nameAttr(element->GetAttribute("name"));
                     if (!nameAttr.empty())
                     {
-                        SetName(ToUtf8(nameAttr));
+                        SetName(nameAttr);
                     }
                     else
                     {
                         throw std::runtime_error("package element has no 'name' attribute in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                             std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                     }
-                    std::u32string sourceRootDirAttr = element->GetAttribute(U"sourceRootDir");
+                    std::string sourceRootDirAttr(element->GetAttribute("sourceRootDir"));
                     if (!sourceRootDirAttr.empty())
                     {
-                        pathMatcher.SetSourceRootDir(ToUtf8(sourceRootDirAttr));
+                        pathMatcher.SetSourceRootDir(sourceRootDirAttr);
                         SetSourceRootDir(pathMatcher.SourceRootDir());
                     }
                     else
@@ -112,56 +112,56 @@ Package::Package(PathMatcher& pathMatcher, sngxml::dom::Document* doc) :
                         throw std::runtime_error("package element has no 'sourceRootDir' attribute in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                             std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                     }
-                    std::u32string targetRootDirAttr = element->GetAttribute(U"targetRootDir");
+                    std::string targetRootDirAttr(element->GetAttribute("targetRootDir"));
                     if (!targetRootDirAttr.empty())
                     {
-                        SetTargetRootDir(ToUtf8(targetRootDirAttr));
+                        SetTargetRootDir(targetRootDirAttr);
                     }
                     else
                     {
                         throw std::runtime_error("package element has no 'targetRootDir' attribute in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                             std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                     }
-                    std::u32string appNameAttr = element->GetAttribute(U"appName");
+                    std::string appNameAttr(element->GetAttribute("appName"));
                     if (!appNameAttr.empty())
                     {
-                        SetAppName(ToUtf8(appNameAttr));
+                        SetAppName(appNameAttr);
                     }
                     else
                     {
                         throw std::runtime_error("package element has no 'appname' attribute in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                             std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                     }
-                    std::u32string publisherAttr = element->GetAttribute(U"publisher");
+                    std::string publisherAttr(element->GetAttribute("publisher"));
                     if (!publisherAttr.empty())
                     {
-                        SetPublisher(ToUtf8(publisherAttr));
+                        SetPublisher(publisherAttr);
                     }
-                    std::u32string iconFilePathAttr = element->GetAttribute(U"iconFilePath");
+                    std::string iconFilePathAttr(element->GetAttribute("iconFilePath"));
                     if (!iconFilePathAttr.empty())
                     {
-                        SetIconFilePath(ToUtf8(iconFilePathAttr));
+                        SetIconFilePath(iconFilePathAttr);
                     }
-                    std::u32string compressionAttr = element->GetAttribute(U"compression");
+                    std::string compressionAttr(element->GetAttribute("compression"));
                     if (!compressionAttr.empty())
                     {
-                        SetCompression(ParseCompressionStr(ToUtf8(compressionAttr)));
+                        SetCompression(ParseCompressionStr(compressionAttr));
                     }
-                    std::u32string versionAttr = element->GetAttribute(U"version");
+                    std::string versionAttr(element->GetAttribute("version"));
                     if (!versionAttr.empty())
                     {
-                        SetVersion(ToUtf8(versionAttr));
+                        SetVersion(versionAttr);
                     }
                     else
                     {
                         SetVersion("1.0.0");
                     }
-                    std::u32string includeUninstallerAttr = element->GetAttribute(U"includeUninstaller");
+                    std::string includeUninstallerAttr(element->GetAttribute("includeUninstaller"));
                     if (!includeUninstallerAttr.empty())
                     {
                         try
                         {
-                            includeUninstaller = ParseBool(ToUtf8(includeUninstallerAttr));
+                            includeUninstaller = ParseBool(includeUninstallerAttr);
                         }
                         catch (const std::exception& ex)
                         {
@@ -172,10 +172,10 @@ Package::Package(PathMatcher& pathMatcher, sngxml::dom::Document* doc) :
                     {
                         includeUninstaller = true;
                     }
-                    std::u32string idAttr = element->GetAttribute(U"id");
+                    std::string idAttr(element->GetAttribute("id"));
                     if (!idAttr.empty())
                     {
-                        SetId(boost::lexical_cast<boost::uuids::uuid>(ToUtf8(idAttr)));
+                        SetId(boost::lexical_cast<boost::uuids::uuid>(idAttr));
                     }
                     else
                     {
@@ -694,82 +694,103 @@ void Package::ReadData(BinaryStreamReader& reader)
     }
 }
 
-sngxml::dom::Element* Package::ToXml() const
+void Package::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"packageIndex");
-    element->SetAttribute(U"name", ToUtf32(Name()));
-    element->SetAttribute(U"appName", ToUtf32(appName));
-    element->SetAttribute(U"publisher", ToUtf32(publisher));
-    element->SetAttribute(U"iconFilePath", ToUtf32(iconFilePath));
-    element->SetAttribute(U"sourceRootDir", ToUtf32(sourceRootDir));
-    element->SetAttribute(U"targetRootDir", ToUtf32(targetRootDir));
-    element->SetAttribute(U"compression", ToUtf32(CompressionStr(compression)));
-    element->SetAttribute(U"version", ToUtf32(version));
-    element->SetAttribute(U"id", ToUtf32(boost::lexical_cast<std::string>(id)));
-    element->SetAttribute(U"includeUninstaller", ToUtf32(ToString(includeUninstaller)));
     for (const auto& component : components)
     {
-        sngxml::dom::Element* child = component->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        component->VisitData(reader, visitor);
+    }
+}
+
+void Package::WriteXml(sngxml::xml::XmlWriter& writer) const
+{
+    writer.StartElement("packageIndex");
+    writer.Attribute("name", Name());
+    writer.Attribute("appName", appName);
+    writer.Attribute("publisher", publisher);
+    writer.Attribute("iconFilePath", iconFilePath);
+    writer.Attribute("sourceRootDir", sourceRootDir);
+    writer.Attribute("targetRootDir", targetRootDir);
+    writer.Attribute("compression", CompressionStr(compression));
+    writer.Attribute("version", version);
+    writer.Attribute("id", boost::lexical_cast<std::string>(id));
+    writer.Attribute("includeUninstaller", ToString(includeUninstaller));
+    for (const auto& component : components)
+    {
+        component->WriteXml(writer);
     }
     if (environment != nullptr)
     {
-        sngxml::dom::Element* child = environment->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        environment->WriteXml(writer);
     }
     if (links != nullptr)
     {
-        sngxml::dom::Element* child = links->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        links->WriteXml(writer);
     }
-    sngxml::dom::Element* variablesElement = variables.ToXml();
-    element->AppendChild(std::unique_ptr<sngxml::dom::Node>(variablesElement));
-    return element;
+    variables.WriteXml(writer);
+    writer.EndElement();
 }
 
-std::unique_ptr<sngxml::dom::Document> Package::XmlDoc() const
-{
-    std::unique_ptr<sngxml::dom::Document> doc(new sngxml::dom::Document());
-    doc->AppendChild(std::unique_ptr<sngxml::dom::Node>(ToXml()));
-    return doc;
-}
+// The index is written element by element as the package tree is walked, so no DOM tree is built for it.
 
 void Package::WriteIndexToXmlFile(const std::string& xmlFilePath)
 {
     std::ofstream file(xmlFilePath);
-    CodeFormatter formatter(file);
-    formatter.SetIndentSize(1);
-    std::unique_ptr<sngxml::dom::Document> doc = XmlDoc();
-    doc->Write(formatter);
+    sngxml::xml::XmlWriter writer(file, 1);
+    WriteXml(writer);
+    writer.Flush();
 }
 
-std::unique_ptr<sngxml::dom::Document> Package::InfoDoc() const
+void Package::WriteInfoXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* rootElement = new sngxml::dom::Element(U"packageInfo");
-    rootElement->SetAttribute(U"appName", ToUtf32(appName));
-    rootElement->SetAttribute(U"appVersion", ToUtf32(version));
-    rootElement->SetAttribute(U"publisher", ToUtf32(publisher));
-    rootElement->SetAttribute(U"iconFilePath", ToUtf32(iconFilePath));
-    rootElement->SetAttribute(U"compression", ToUtf32(CompressionStr(compression)));
+    writer.StartElement("packageInfo");
+    writer.Attribute("appName", appName);
+    writer.Attribute("appVersion", version);
+    writer.Attribute("publisher", publisher);
+    writer.Attribute("iconFilePath", iconFilePath);
+    writer.Attribute("compression", CompressionStr(compression));
     std::string installDirName = Path::GetFileName(targetRootDir);
-    rootElement->SetAttribute(U"installDirName", ToUtf32(installDirName));
+    writer.Attribute("installDirName", installDirName);
     std::string defaultContainingDirPath = Path::GetDirectoryName(GetFullPath(targetRootDir));
-    rootElement->SetAttribute(U"defaultContainingDirPath", ToUtf32(defaultContainingDirPath));
-    rootElement->SetAttribute(U"uncompressedPackageSize", ToUtf32(std::to_string(size)));
-    rootElement->SetAttribute(U"includeUninstaller", ToUtf32(ToString(includeUninstaller)));
-    rootElement->SetAttribute(U"id", ToUtf32(boost::lexical_cast<std::string>(id)));
-    std::unique_ptr<sngxml::dom::Document> doc(new sngxml::dom::Document());
-    doc->AppendChild(std::unique_ptr<sngxml::dom::Node>(rootElement));
-    return doc;
+    writer.Attribute("defaultContainingDirPath", defaultContainingDirPath);
+    writer.Attribute("uncompressedPackageSize", std::to_string(size));
+    writer.Attribute("includeUninstaller", ToString(includeUninstaller));
+    writer.Attribute("id", boost::lexical_cast<std::string>(id));
+    writer.EndElement();
 }
 
 void Package::WriteInfoXmlFile(const std::string& xmlFilePath)
 {
     std::ofstream file(xmlFilePath);
-    CodeFormatter formatter(file);
-    formatter.SetIndentSize(1);
-    std::unique_ptr<sngxml::dom::Document> doc = InfoDoc();
-    doc->Write(formatter);
+    sngxml::xml::XmlWriter writer(file, 1);
+    WriteInfoXml(writer);
+    writer.Flush();
+}
+
+// Writes out the data buffered in the write streams from the outermost stream inwards, so that write errors are reported instead of being ignored by the destructors of the streams.
+
+void FinishWriteStreams(Streams& streams)
+{
+    for (int i = streams.Count() - 1; i >= 0; --i)
+    {
+        Stream* stream = streams.Get(i);
+        if (DeflateStream* deflateStream = dynamic_cast<DeflateStream*>(stream))
+        {
+            deflateStream->Finish();
+        }
+        else if (BZip2Stream* bzip2Stream = dynamic_cast<BZip2Stream*>(stream))
+        {
+            bzip2Stream->Finish();
+        }
+        else if (ChecksumFrameStream* frameStream = dynamic_cast<ChecksumFrameStream*>(stream))
+        {
+            frameStream->Finish();
+        }
+        else
+        {
+            stream->Flush();
+        }
+    }
 }
 
 void Package::Create(const std::string& filePath, Content content)
@@ -785,7 +806,7 @@ void Package::Create(const std::string& filePath, Content content)
             fileContentSize = 0;
             fileContentPos = 0;
             BinaryStreamWriter uncompressedStreamWriter(*uncompressedStream);
-            uncompressedStreamWriter.Write(std::uint8_t(compression));
+            uncompressedStreamWriter.Write(std::uint8_t(std::uint8_t(compression) | checksumFramesFlag));
             uncompressedStreamWriter.Write(targetRootDir);
             if ((content & Content::preinstall) != Content::none)
             {
@@ -808,6 +829,7 @@ void Package::Create(const std::string& filePath, Content content)
                 WriteData(writer);
             }
             size = writer.Position() - streamStartPosition;
+            FinishWriteStreams(streams);
             SetComponent(nullptr);
             SetFile(nullptr);
             SetStatus(Status::succeeded, "writing succeeded", std::string());
@@ -820,6 +842,53 @@ std::string Package::ExpandPath(const std::string& path) const
     return variables.ExpandPath(path);
 }
 
+// Reads the package header, sets up the decompression streams and handles the preinstall component. The preinstall commands are run when installing.
+// Otherwise the preinstall component is skipped. The index and the data are read from the last of the returned streams.
+
+Streams Package::ReadHeader(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content, bool runPreinstallCommands)
+{
+    Streams streams = GetReadBaseStream(dataSource, filePath, data, size);
+    if (streams.Count() > 0)
+    {
+        includeFileContent = false;
+        Stream* uncompressedStream = streams.Get(0);
+        BinaryStreamReader uncompressedStreamReader(*uncompressedStream);
+        uint8_t compressionByte = uncompressedStreamReader.ReadByte();
+        Compression packageCompression = static_cast<Compression>(compressionByte & ~checksumFramesFlag);
+        bool checksumFrames = (compressionByte & checksumFramesFlag) != 0;
+        std::string packageTargetRootDir = uncompressedStreamReader.ReadUtf8String();
+        if (targetRootDir.empty())
+        {
+            SetTargetRootDir(packageTargetRootDir);
+        }
+        AddReadCompressionStreams(streams, packageCompression, checksumFrames);
+        if ((content & Content::preinstall) != Content::none)
+        {
+            bool hasPreinstallComponent = uncompressedStreamReader.ReadBool();
+            if (hasPreinstallComponent)
+            {
+                if (runPreinstallCommands)
+                {
+                    SetPreinstallDir(GetFullPath(Path::Combine(GetTargetRootDir(), boost::lexical_cast<std::string>(boost::uuids::random_generator()()))));
+                    SetStatus(Status::running, "checking prerequisites...", std::string());
+                    SetPreinstallComponent(new PreinstallComponent());
+                    preinstallComponent->Read(streams);
+                    preinstallComponent->RunCommands();
+                }
+                else
+                {
+                    SetPreinstallComponent(new PreinstallComponent());
+                    static_cast<PreinstallComponent*>(preinstallComponent.get())->Skip(streams);
+                }
+            }
+        }
+        fileContentSize = 0;
+        fileContentPos = 0;
+        includeFileContent = true;
+    }
+    return streams;
+}
+
 void Package::Install(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content)
 {
     InfoItem* uncompressedSizeItem = GetInfoItem(InfoItemKind::uncompressedPackageSize);
@@ -832,34 +901,9 @@ void Package::Install(DataSource dataSource, const std::string& filePath, uint8_
     {
         if (content != Content::none)
         {
-            Streams streams = GetReadBaseStream(dataSource, filePath, data, size);
+            Streams streams = ReadHeader(dataSource, filePath, data, size, content, true);
             if (streams.Count() > 0)
             {
-                includeFileContent = false;
-                Stream* uncompressedStream = streams.Get(0);
-                BinaryStreamReader uncompressedStreamReader(*uncompressedStream);
-                Compression packageCompression = static_cast<Compression>(uncompressedStreamReader.ReadByte());
-                std::string packageTargetRootDir = uncompressedStreamReader.ReadUtf8String();
-                if (targetRootDir.empty())
-                {
-                    SetTargetRootDir(packageTargetRootDir);
-                }
-                AddReadCompressionStreams(streams, packageCompression);
-                if ((content & Content::preinstall) != Content::none)
-                {
-                    bool hasPreinstallComponent = uncompressedStreamReader.ReadBool();
-                    if (hasPreinstallComponent)
-                    {
-                        SetPreinstallDir(GetFullPath(Path::Combine(GetTargetRootDir(), boost::lexical_cast<std::string>(boost::uuids::random_generator()()))));
-                        SetStatus(Status::running, "checking prerequisites...", std::string());
-                        SetPreinstallComponent(new PreinstallComponent());
-                        preinstallComponent->Read(streams);
-                        preinstallComponent->RunCommands();
-                    }
-                }
-                fileContentSize = 0;
-                fileContentPos = 0;
-                includeFileContent = true;
                 stream = &streams.Back();
                 stream->AddObserver(&streamObserver);
                 BinaryStreamReader reader(*stream);
@@ -912,6 +956,23 @@ void Package::Install(DataSource dataSource, const std::string& filePath, uint8_
     }
 }
 
+Streams Package::ReadPackageIndex(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content)
+{
+    if ((content & Content::index) == Content::none)
+    {
+        throw std::runtime_error("package content does not include index");
+    }
+    Streams streams = ReadHeader(dataSource, filePath, data, size, content, false);
+    if (streams.Count() > 0)
+    {
+        BinaryStreamReader reader(streams.Back());
+        streamStartPosition = reader.Position();
+        ReadIndex(reader);
+        SetComponent(nullptr);
+    }
+    return streams;
+}
+
 void Package::Uninstall()
 {
     ResetAction();
@@ -1032,12 +1093,20 @@ Streams Package::GetReadBaseStream(DataSource dataSource, const std::string& fil
     return streams;
 }
 
-void Package::AddReadCompressionStreams(Streams& streams, Compression comp)
+void Package::AddReadCompressionStreams(Streams& streams, Compression comp, bool checksumFrames)
 {
+    if (checksumFrames)
+    {
+        streams.Add(new ChecksumFrameStream(FrameMode::read, streams.Back()));
+    }
     switch (comp)
     {
         case Compression::none:
         {
+            if (checksumFrames)
+            {
+                streams.Add(new BufferedStream(streams.Back()));
+            }
             break;
         }
         case Compression::deflate:
@@ -1059,6 +1128,7 @@ Streams Package::GetWriteStreams(const std::string& filePath)
 {
     Streams streams;
     streams.Add(new FileStream(filePath, OpenMode::write | OpenMode::binary));
+    streams.Add(new ChecksumFrameStream(FrameMode::write, streams.Back()));
     switch (compression)
     {
         case Compression::none:
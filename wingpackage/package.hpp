@@ -50,6 +50,11 @@ inline Content operator~(Content operand)
     return Content(~uint8_t(operand));
 }
 
+// Set in the compression byte of the package header when the rest of the package is written as CRC-32C checksummed frames.
+// Packages without the flag are read without frame verification.
+
+const uint8_t checksumFramesFlag = 0x80;
+
 enum class Action : int
 {
     abortAction, continueAction
@@ -149,15 +154,16 @@ public:
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
-    sngxml::dom::Element* ToXml() const override;
-    std::unique_ptr<sngxml::dom::Document> XmlDoc() const;
-    std::unique_ptr<sngxml::dom::Document> InfoDoc() const;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
+    void WriteInfoXml(sngxml::xml::XmlWriter& writer) const;
     void WriteIndexToXmlFile(const std::string& xmlFilePath);
     void WriteInfoXmlFile(const std::string& xmlFilePath);
     void Create(const std::string& filePath, Content content);
     int64_t Size() const { return size; }
     std::string ExpandPath(const std::string& str) const;
     void Install(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content);
+    Streams ReadPackageIndex(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content);
     void Uninstall() override;
     void RunUninstallCommands();
     void RunUninstallCommand(const std::string& uninstallCommand);
@@ -177,7 +183,8 @@ public:
     void IncrementFileContentPosition(int64_t amount);
 private:
     Streams GetReadBaseStream(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size);
-    void AddReadCompressionStreams(Streams& streams, Compression comp);
+    Streams ReadHeader(DataSource dataSource, const std::string& filePath, uint8_t* data, int64_t size, Content content, bool runPreinstallCommands);
+    void AddReadCompressionStreams(Streams& streams, Compression comp, bool checksumFrames);
     Streams GetWriteStreams(const std::string& filePath);
     void NotifyStatusChanged();
     void NotifyComponentChanged();
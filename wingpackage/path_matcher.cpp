@@ -4,12 +4,12 @@
 // =================================
 
 #include <wingpackage/path_matcher.hpp>
+#include <wing/FileUtil.hpp>
 #include <sngxml/xpath/XPathEvaluate.hpp>
 #include <soulng/rex/Match.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/TextUtils.hpp>
 #include <soulng/util/Unicode.hpp>
-#include <boost/filesystem.hpp>
 
 namespace wingstall { namespace wingpackage {
 
@@ -27,7 +27,7 @@ DirectoryInfo::DirectoryInfo(const std::string& name_, std::time_t time_, sngxml
 PathRule::PathRule(PathMatcher& pathMatcher, std::string name_, RuleKind ruleKind_, PathKind pathKind_) :
     element(nullptr), name(name_), ruleKind(ruleKind_), pathKind(pathKind_)
 {
-    nfa = soulng::rex::CompileFilePattern(pathMatcher.GetContext(), ToUtf32(name));
+    matcher = pathMatcher.GetContext().GetFilePatternMatcher(ToUtf32(name));
 }
 
 PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
@@ -79,7 +79,7 @@ PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
                     throw std::runtime_error("the value of the 'name' attribute may not have '/' or '\\' characters in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                         std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                 }
-                nfa = soulng::rex::CompileFilePattern(pathMatcher.GetContext(), nameAttr);
+                matcher = pathMatcher.GetContext().GetFilePatternMatcher(nameAttr);
                 name = ToUtf8(nameAttr);
             }
             else if (element->Name() == U"file")
@@ -91,7 +91,7 @@ PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
                     throw std::runtime_error("the value of the 'name' attribute may not have '/' or '\\' characters in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                         std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
                 }
-                nfa = soulng::rex::CompileFilePattern(pathMatcher.GetContext(), nameAttr);
+                matcher = pathMatcher.GetContext().GetFilePatternMatcher(nameAttr);
                 name = ToUtf8(nameAttr);
             }
         }
@@ -113,7 +113,7 @@ PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
                 throw std::runtime_error("the value of the 'dir' attribute may not have '/' or '\\' characters in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                     std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
             }
-            nfa = soulng::rex::CompileFilePattern(pathMatcher.GetContext(), dirAttr);
+            matcher = pathMatcher.GetContext().GetFilePatternMatcher(dirAttr);
             name = ToUtf8(dirAttr);
         }
         std::u32string fileAttr = element->GetAttribute(U"file");
@@ -131,7 +131,7 @@ PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
                 throw std::runtime_error("the value of the 'file' attribute may not have '/' or '\\' characters in package XML document '" + pathMatcher.XmlFilePath() + "' line " + 
                     std::to_string(element->GetSourcePos().line) + ", column " + std::to_string(element->GetSourcePos().col));
             }
-            nfa = soulng::rex::CompileFilePattern(pathMatcher.GetContext(), fileAttr);
+            matcher = pathMatcher.GetContext().GetFilePatternMatcher(fileAttr);
             name = ToUtf8(fileAttr);
         }
         if (dirAttr.empty() && fileAttr.empty())
@@ -142,12 +142,84 @@ PathRule::PathRule(PathMatcher& pathMatcher, sngxml::dom::Element* element_) :
     }
 }
 
-bool PathRule::Matches(const std::string& name)
+bool PathRule::Matches(const std::string& name) const
 {
-    return soulng::rex::PatternMatch(ToUtf32(name), nfa);
+    return matcher->Match(name);
 }
 
-PathRuleSet::PathRuleSet(PathRuleSet* parentRuleSet_) : parentRuleSet(parentRuleSet_)
+PathRuleSetMatcher::PathRuleSetMatcher()
+{
+}
+
+void PathRuleSetMatcher::AddRule(PathRule* rule)
+{
+    rules.push_back(rule);
+}
+
+void PathRuleSetMatcher::Compile()
+{
+    std::vector<soulng::rex::Nfa> nfas;
+    int n = rules.size();
+    for (int i = 0; i < n; ++i)
+    {
+        const soulng::rex::FilePatternMatcher& matcher = rules[i]->Matcher();
+        switch (matcher.Kind())
+        {
+            case soulng::rex::FilePatternKind::exact:
+            {
+                exactRules[matcher.Literal()] = i;
+                break;
+            }
+            case soulng::rex::FilePatternKind::automaton:
+            {
+                automatonRules.push_back(i);
+                nfas.push_back(matcher.GetNfa());
+                break;
+            }
+            default:
+            {
+                literalRules.push_back(i);
+                break;
+            }
+        }
+    }
+    dfa = soulng::rex::MakeDfa(nfas);
+}
+
+bool PathRuleSetMatcher::Include(const std::string& name) const
+{
+    int match = -1;
+    if (!exactRules.empty())
+    {
+        auto it = exactRules.find(name);
+        if (it != exactRules.cend())
+        {
+            match = it->second;
+        }
+    }
+    for (auto it = literalRules.crbegin(); it != literalRules.crend(); ++it)
+    {
+        int index = *it;
+        if (index <= match) break;
+        if (rules[index]->Matches(name))
+        {
+            match = index;
+            break;
+        }
+    }
+    if (!automatonRules.empty() && automatonRules.back() > match)
+    {
+        int value = dfa.MatchValueUtf8(name);
+        if (value != soulng::rex::dfaNoAcceptValue)
+        {
+            match = std::max(match, automatonRules[value]);
+        }
+    }
+    if (match == -1) return true;
+    return (rules[match]->GetRuleKind() & RuleKind::include) != RuleKind::none;
+}
+
+PathRuleSet::PathRuleSet(const std::shared_ptr<PathRuleSet>& parentRuleSet_) : parentRuleSet(parentRuleSet_)
 {
 }
 
@@ -167,101 +239,60 @@ PathRule* PathRuleSet::GetRule(const std::string& name) const
     return nullptr;
 }
 
-bool PathRuleSet::IncludeDir(const std::string& dirName) const
+// Rules of the set take precedence over the cascading rules of the parent sets, and the cascading rules of a closer parent over those of a more distant one.
+// Adding the cascading rules from the most distant parent first and the rules of the set last makes the last matching rule the deciding one.
+
+void PathRuleSet::Compile()
 {
-    bool include = true;
-    bool matched = false;
-    for (const auto& rule : rules)
+    std::vector<PathRuleSet*> parents;
+    for (PathRuleSet* parent = parentRuleSet.get(); parent; parent = parent->parentRuleSet.get())
     {
-        if (rule->GetPathKind() == PathKind::dir)
-        {
-            if ((rule->GetRuleKind() & RuleKind::include) != RuleKind::none && rule->Matches(dirName))
-            {
-                include = true;
-                matched = true;
-            }
-            else if ((rule->GetRuleKind() & RuleKind::exclude) != RuleKind::none && rule->Matches(dirName))
-            {
-                include = false;
-                matched = true;
-            }
-        }
+        parents.push_back(parent);
     }
-    PathRuleSet* parent = parentRuleSet;
-    while (parent && !matched)
+    for (auto it = parents.crbegin(); it != parents.crend(); ++it)
     {
-        for (const auto& rule : parent->rules)
+        for (const auto& rule : (*it)->rules)
         {
-            if (rule->GetPathKind() == PathKind::dir)
+            if ((rule->GetRuleKind() & RuleKind::cascade) != RuleKind::none)
             {
-                if ((rule->GetRuleKind() & RuleKind::cascade) != RuleKind::none)
+                if (rule->GetPathKind() == PathKind::dir)
+                {
+                    dirMatcher.AddRule(rule.get());
+                }
+                else if (rule->GetPathKind() == PathKind::file)
                 {
-                    if ((rule->GetRuleKind() & RuleKind::include) != RuleKind::none && rule->Matches(dirName))
-                    {
-                        include = true;
-                        matched = true;
-                    }
-                    else if ((rule->GetRuleKind() & RuleKind::exclude) != RuleKind::none && rule->Matches(dirName))
-                    {
-                        include = false;
-                        matched = true;
-                    }
+                    fileMatcher.AddRule(rule.get());
                 }
             }
         }
-        parent = parent->parentRuleSet;
     }
-    return include;
-}
-
-bool PathRuleSet::IncludeFile(const std::string& fileName) const
-{
-    bool include = true;
-    bool matched = false;
     for (const auto& rule : rules)
     {
-        if (rule->GetPathKind() == PathKind::file)
+        if (rule->GetPathKind() == PathKind::dir)
         {
-            if ((rule->GetRuleKind() & RuleKind::include) != RuleKind::none && rule->Matches(fileName))
-            {
-                include = true;
-                matched = true;
-            }
-            else if ((rule->GetRuleKind() & RuleKind::exclude) != RuleKind::none && rule->Matches(fileName))
-            {
-                include = false;
-                matched = true;
-            }
+            dirMatcher.AddRule(rule.get());
         }
-    }
-    PathRuleSet* parent = parentRuleSet;
-    while (parent && !matched)
-    {
-        for (const auto& rule : parent->rules)
+        else if (rule->GetPathKind() == PathKind::file)
         {
-            if (rule->GetPathKind() == PathKind::file)
-            {
-                if ((rule->GetRuleKind() & RuleKind::cascade) != RuleKind::none)
-                {
-                    if ((rule->GetRuleKind() & RuleKind::include) != RuleKind::none && rule->Matches(fileName))
-                    {
-                        include = true;
-                        matched = true;
-                    }
-                    else if ((rule->GetRuleKind() & RuleKind::exclude) != RuleKind::none && rule->Matches(fileName))
-                    {
-                        include = false;
-                        matched = true;
-                    }
-                }
-            }
+            fileMatcher.AddRule(rule.get());
         }
-        parent = parent->parentRuleSet;
     }
-    return include;
+    dirMatcher.Compile();
+    fileMatcher.Compile();
+}
+
+bool PathRuleSet::IncludeDir(const std::string& dirName) const
+{
+    return dirMatcher.Include(dirName);
 }
 
-PathMatcher::PathMatcher(const std::string& xmlFilePath_) : xmlFilePath(xmlFilePath_), rootDir(Path::GetDirectoryName(GetFullPath(xmlFilePath)))
+bool PathRuleSet::IncludeFile(const std::string& fileName) const
+{
+    return fileMatcher.Include(fileName);
+}
+
+PathMatcher::PathMatcher(const std::string& xmlFilePath_) : xmlFilePath(xmlFilePath_), rootDir(Path::GetDirectoryName(GetFullPath(xmlFilePath))),
+    scanObserver(nullptr), scanSnapshot(nullptr), threadBudget(nullptr)
 {
 }
 
@@ -273,29 +304,21 @@ void PathMatcher::SetSourceRootDir(const std::string& sourceRootDir_)
 
 void PathMatcher::BeginFiles(sngxml::dom::Element* element)
 {
-    PathRuleSet* parentRuleSet = ruleSet.get();
+    std::shared_ptr<PathRuleSet> parentRuleSet = ruleSet;
     ruleSetStack.push(std::move(ruleSet));
     ruleSet.reset(new PathRuleSet(parentRuleSet));
     ruleSet->AddRule(new PathRule(*this, "*", RuleKind::exclude, PathKind::file));
-    std::unique_ptr<sngxml::xpath::XPathObject> ruleObject = sngxml::xpath::Evaluate(U"file", element);
-    if (ruleObject)
+    static const std::shared_ptr<sngxml::xpath::CompiledXPath> fileQuery = sngxml::xpath::Compile(U"file");
+    for (sngxml::dom::Node* node : fileQuery->Select(element))
     {
-        if (ruleObject->Type() == sngxml::xpath::XPathObjectType::nodeSet)
+        if (node->GetNodeType() == sngxml::dom::NodeType::elementNode)
         {
-            sngxml::xpath::XPathNodeSet* nodeSet = static_cast<sngxml::xpath::XPathNodeSet*>(ruleObject.get());
-            int n = nodeSet->Length();
-            for (int i = 0; i < n; ++i)
-            {
-                sngxml::dom::Node* node = (*nodeSet)[i];
-                if (node->GetNodeType() == sngxml::dom::NodeType::elementNode)
-                {
-                    sngxml::dom::Element* childElement = static_cast<sngxml::dom::Element*>(node);
-                    PathRule* rule = new PathRule(*this, childElement);
-                    ruleSet->AddRule(rule);
-                }
-            }
+            sngxml::dom::Element* childElement = static_cast<sngxml::dom::Element*>(node);
+            PathRule* rule = new PathRule(*this, childElement);
+            ruleSet->AddRule(rule);
         }
     }
+    ruleSet->Compile();
 }
 
 void PathMatcher::EndFiles()
@@ -304,103 +327,73 @@ void PathMatcher::EndFiles()
     ruleSetStack.pop();
 }
 
-void PathMatcher::BeginDirectory(const std::string& name, sngxml::dom::Element* element)
+DirectoryContent PathMatcher::ReadDirectory() const
 {
-    PathRuleSet* parentRuleSet = ruleSet.get();
-    ruleSetStack.push(std::move(ruleSet));
-    ruleSet.reset(new PathRuleSet(parentRuleSet));
-    dirStack.push(currentDir);
-    currentDir = Path::Combine(currentDir, name);
+    return wingpackage::ReadDirectory(currentDir, *ruleSet);
+}
+
+std::vector<DirectoryInfo> PathMatcher::Directories() const
+{
+    return ReadDirectory().directories;
+}
+
+std::vector<FileInfo> PathMatcher::Files() const
+{
+    return ReadDirectory().files;
+}
+
+// The rules of a directory are the element children of its directory element, in document order.
+// Walking the children directly instead of evaluating an XPath expression only reads the document, so rule sets can be built on several threads at once.
+
+std::shared_ptr<PathRuleSet> MakeDirectoryRuleSet(PathMatcher& pathMatcher, const std::shared_ptr<PathRuleSet>& parentRuleSet, sngxml::dom::Element* element)
+{
+    std::shared_ptr<PathRuleSet> ruleSet(new PathRuleSet(parentRuleSet));
     if (element)
     {
-        std::unique_ptr<sngxml::xpath::XPathObject> ruleObject = sngxml::xpath::Evaluate(U"*", element);
-        if (ruleObject)
+        for (sngxml::dom::Node* node = element->FirstChild(); node; node = node->NextSibling())
         {
-            if (ruleObject->Type() == sngxml::xpath::XPathObjectType::nodeSet)
+            if (node->GetNodeType() == sngxml::dom::NodeType::elementNode)
             {
-                sngxml::xpath::XPathNodeSet* nodeSet = static_cast<sngxml::xpath::XPathNodeSet*>(ruleObject.get());
-                int n = nodeSet->Length();
-                for (int i = 0; i < n; ++i)
-                {
-                    sngxml::dom::Node* node = (*nodeSet)[i];
-                    if (node->GetNodeType() == sngxml::dom::NodeType::elementNode)
-                    {
-                        sngxml::dom::Element* childElement = static_cast<sngxml::dom::Element*>(node);
-                        PathRule* rule = new PathRule(*this, childElement);
-                        ruleSet->AddRule(rule);
-                    }
-                }
+                sngxml::dom::Element* childElement = static_cast<sngxml::dom::Element*>(node);
+                PathRule* rule = new PathRule(pathMatcher, childElement);
+                ruleSet->AddRule(rule);
             }
         }
     }
+    ruleSet->Compile();
+    return ruleSet;
 }
 
-void PathMatcher::EndDirectory()
-{
-    ruleSet = std::move(ruleSetStack.top());
-    ruleSetStack.pop();
-    currentDir = std::move(dirStack.top());
-    dirStack.pop();
-}
+// Enumerates a directory once and evaluates both the directory and the file rules against the entries.
 
-std::vector<DirectoryInfo> PathMatcher::Directories() const
+DirectoryContent ReadDirectory(const std::string& directoryPath, const PathRuleSet& ruleSet)
 {
-    std::vector<DirectoryInfo> directories;
-    boost::system::error_code ec;
-    boost::filesystem::directory_iterator it(currentDir, ec);
-    if (ec)
+    DirectoryContent content;
+    std::vector<wing::DirectoryEntry> entries = wing::ReadDirectory(directoryPath);
+    for (const wing::DirectoryEntry& entry : entries)
     {
-        throw std::runtime_error("could not iterate directory '" + currentDir + "': " + PlatformStringToUtf8(ec.message()));
-    }
-    while (it != boost::filesystem::directory_iterator())
-    {
-        if (boost::filesystem::is_directory(it->status()))
+        if (entry.kind == wing::DirectoryEntryKind::directory)
         {
-            if (!it->path().filename_is_dot() && !it->path().filename_is_dot_dot())
+            if (ruleSet.IncludeDir(entry.name))
             {
-                std::string name = it->path().filename().generic_string();
-                if (ruleSet->IncludeDir(name))
+                sngxml::dom::Element* element = nullptr;
+                PathRule* rule = ruleSet.GetRule(entry.name);
+                if (rule)
                 {
-                    sngxml::dom::Element* element = nullptr;
-                    PathRule* rule = ruleSet->GetRule(name);
-                    if (rule)
-                    {
-                        element = rule->GetElement();
-                    }
-                    std::time_t time = boost::filesystem::last_write_time(it->path());
-                    DirectoryInfo directoryInfo(name, time, element);
-                    directories.push_back(directoryInfo);
+                    element = rule->GetElement();
                 }
+                content.directories.push_back(DirectoryInfo(entry.name, entry.time, element));
             }
         }
-        ++it;
-    }
-    return directories;
-}
-
-std::vector<FileInfo> PathMatcher::Files() const
-{
-    std::vector<FileInfo> files;
-    boost::system::error_code ec;
-    boost::filesystem::directory_iterator it(currentDir, ec);
-    if (ec)
-    {
-        throw std::runtime_error("could not iterate directory '" + currentDir + "': " + PlatformStringToUtf8(ec.message()));
-    }
-    while (it != boost::filesystem::directory_iterator())
-    {
-        if (boost::filesystem::is_regular_file(it->status()))
+        else if (entry.kind == wing::DirectoryEntryKind::file)
         {
-            std::string name = it->path().filename().generic_string();
-            if (ruleSet->IncludeFile(name))
+            if (ruleSet.IncludeFile(entry.name))
             {
-                FileInfo fileInfo(name, boost::filesystem::file_size(it->path()), boost::filesystem::last_write_time(it->path()));
-                files.push_back(fileInfo);
+                content.files.push_back(FileInfo(entry.name, entry.size, entry.time));
             }
         }
-        ++it;
     }
-    return files;
+    return content;
 }
 
 } } // namespace wingstall::wingpackage
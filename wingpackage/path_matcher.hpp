@@ -7,9 +7,12 @@
 #define WINGSTALL_WINGPACKAGE_PATH_MATCHER_INCLUDED
 #include <sngxml/dom/Element.hpp>
 #include <soulng/rex/Context.hpp>
+#include <soulng/rex/FilePattern.hpp>
 #include <soulng/rex/Match.hpp>
 #include <soulng/rex/Nfa.hpp>
+#include <memory>
 #include <stack>
+#include <unordered_map>
 #include <ctime>
 
 namespace wingstall { namespace wingpackage {
@@ -30,6 +33,12 @@ struct DirectoryInfo
     sngxml::dom::Element* element;
 };
 
+struct DirectoryContent
+{
+    std::vector<DirectoryInfo> directories;
+    std::vector<FileInfo> files;
+};
+
 class PathMatcher;
 
 enum class RuleKind : int
@@ -66,30 +75,58 @@ public:
     RuleKind GetRuleKind() const { return ruleKind; }
     sngxml::dom::Element* GetElement() const { return element; }
     const std::string& Name() const { return name; }
-    bool Matches(const std::string& name);
+    bool Matches(const std::string& name) const;
+    const soulng::rex::FilePatternMatcher& Matcher() const { return *matcher; }
 private:
     sngxml::dom::Element* element;
     std::string name;
     RuleKind ruleKind;
     PathKind pathKind;
-    soulng::rex::Nfa nfa;
+    std::shared_ptr<const soulng::rex::FilePatternMatcher> matcher;
 };
 
+// Decides whether a name is included by rules added in ascending order of precedence: the last matching rule wins, and a name no rule matches is included.
+// Exact name rules are looked up in a hash map, and the rules that need an automaton are combined into a single DFA.
+
+class PathRuleSetMatcher
+{
+public:
+    PathRuleSetMatcher();
+    void AddRule(PathRule* rule);
+    void Compile();
+    bool Include(const std::string& name) const;
+private:
+    std::vector<PathRule*> rules;
+    std::unordered_map<std::string, int> exactRules;
+    std::vector<int> literalRules;
+    std::vector<int> automatonRules;
+    soulng::rex::Dfa dfa;
+};
+
+// Rule sets form a chain from a directory to the component. A rule set is not modified after it has been compiled, so a chain can be shared by scanning tasks running on different threads.
+
 class PathRuleSet
 {
 public:
-    PathRuleSet(PathRuleSet* parentRuleSet_);
-    PathRuleSet* GetParentRuleSet() const { return parentRuleSet; }
+    PathRuleSet(const std::shared_ptr<PathRuleSet>& parentRuleSet_);
+    PathRuleSet* GetParentRuleSet() const { return parentRuleSet.get(); }
     void AddRule(PathRule* rule);
     PathRule* GetRule(const std::string& name) const;
+    void Compile();
     bool IncludeDir(const std::string& dirName) const;
     bool IncludeFile(const std::string& fileName) const;
 private:
-    PathRuleSet* parentRuleSet;
+    std::shared_ptr<PathRuleSet> parentRuleSet;
     std::vector<std::unique_ptr<PathRule>> rules;
     std::map<std::string, PathRule*> ruleMap;
+    PathRuleSetMatcher dirMatcher;
+    PathRuleSetMatcher fileMatcher;
 };
 
+class ScanObserver;
+class ScanSnapshot;
+class ThreadBudget;
+
 class PathMatcher
 {
 public:
@@ -99,10 +136,16 @@ public:
     const std::string& XmlFilePath() const { return xmlFilePath; }
     void BeginFiles(sngxml::dom::Element* element);
     void EndFiles();
-    void BeginDirectory(const std::string& name, sngxml::dom::Element* element);
-    void EndDirectory();
     const std::string& CurrentDir() const { return currentDir; }
+    const std::shared_ptr<PathRuleSet>& CurrentRuleSet() const { return ruleSet; }
+    ScanObserver* GetScanObserver() const { return scanObserver; }
+    void SetScanObserver(ScanObserver* scanObserver_) { scanObserver = scanObserver_; }
+    ScanSnapshot* GetScanSnapshot() const { return scanSnapshot; }
+    void SetScanSnapshot(ScanSnapshot* scanSnapshot_) { scanSnapshot = scanSnapshot_; }
+    ThreadBudget* GetThreadBudget() const { return threadBudget; }
+    void SetThreadBudget(ThreadBudget* threadBudget_) { threadBudget = threadBudget_; }
     soulng::rex::Context& GetContext() { return context; }
+    DirectoryContent ReadDirectory() const;
     std::vector<DirectoryInfo> Directories() const;
     std::vector<FileInfo> Files() const;
 private:
@@ -110,12 +153,17 @@ private:
     std::string xmlFilePath;
     std::string rootDir;
     std::string sourceRootDir;
-    std::stack<std::string> dirStack;
     std::string currentDir;
-    std::stack<std::unique_ptr<PathRuleSet>> ruleSetStack;
-    std::unique_ptr<PathRuleSet> ruleSet;
+    std::stack<std::shared_ptr<PathRuleSet>> ruleSetStack;
+    std::shared_ptr<PathRuleSet> ruleSet;
+    ScanObserver* scanObserver;
+    ScanSnapshot* scanSnapshot;
+    ThreadBudget* threadBudget;
 };
 
+std::shared_ptr<PathRuleSet> MakeDirectoryRuleSet(PathMatcher& pathMatcher, const std::shared_ptr<PathRuleSet>& parentRuleSet, sngxml::dom::Element* element);
+DirectoryContent ReadDirectory(const std::string& directoryPath, const PathRuleSet& ruleSet);
+
 } } // namespace wingstall::wingpackage
 
 #endif // WINGSTALL_WINGPACKAGE_PATH_MATCHER_INCLUDED
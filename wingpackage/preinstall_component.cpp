@@ -5,6 +5,7 @@
 
 #include <wingpackage/preinstall_component.hpp>
 #include <wingpackage/package.hpp>
+#include <wingpackage/data_visitor.hpp>
 #include <wingpackage/file.hpp>
 #include <sngxml/xpath/XPathEvaluate.hpp>
 #include <soulng/util/Path.hpp>
@@ -104,6 +105,15 @@ void PreinstallComponent::Read(Streams& streams)
     ReadData(reader);
 }
 
+void PreinstallComponent::Skip(Streams& streams)
+{
+    BinaryStreamReader reader(streams.Back());
+    Component::ReadIndex(reader);
+    ReadFilesAndCommands(reader);
+    SkipDataVisitor visitor;
+    VisitData(reader, visitor);
+}
+
 void PreinstallComponent::RunCommands()
 {
     Package* package = GetPackage();
@@ -194,6 +204,11 @@ void PreinstallComponent::ReadIndex(BinaryStreamReader& reader)
     {
         throw std::runtime_error("package not set");
     }
+    ReadFilesAndCommands(reader);
+}
+
+void PreinstallComponent::ReadFilesAndCommands(BinaryStreamReader& reader)
+{
     int32_t numFiles = reader.ReadInt();
     for (int32_t i = 0; i < numFiles; ++i)
     {
@@ -201,11 +216,16 @@ void PreinstallComponent::ReadIndex(BinaryStreamReader& reader)
         AddFile(file);
         file->ReadIndex(reader);
     }
+    Package* package = GetPackage();
     int32_t numCommands = reader.ReadInt();
     for (int32_t i = 0; i < numCommands; ++i)
     {
         std::string command = reader.ReadUtf8String();
-        commands.push_back(package->ExpandPath(command));
+        if (package)
+        {
+            command = package->ExpandPath(command);
+        }
+        commands.push_back(command);
     }
 }
 
@@ -259,6 +279,15 @@ void PreinstallComponent::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void PreinstallComponent::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    for (const auto& file : files)
+    {
+        if (visitor.Done()) return;
+        visitor.VisitFileData(file.get(), reader, false);
+    }
+}
+
 void PreinstallComponent::RemovePreinstallDir()
 {
     try
@@ -20,13 +20,17 @@ public:
     PreinstallComponent(PathMatcher& pathMatcher, sngxml::dom::Element* element);
     void Write(Streams& streams) override;
     void Read(Streams& streams) override;
+    void Skip(Streams& streams);
     void RunCommands() override;
     void AddFile(File* file);
+    const std::vector<std::unique_ptr<File>>& Files() const override { return files; }
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
 private:
+    void ReadFilesAndCommands(BinaryStreamReader& reader);
     std::vector<FileInfo> fileInfos;
     std::vector<std::unique_ptr<File>> files;
     std::vector<std::string> commands;
@@ -0,0 +1,271 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/query.hpp>
+#include <wingpackage/package.hpp>
+#include <wingpackage/component.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/environment.hpp>
+#include <wingpackage/links.hpp>
+#include <sngxml/dom/Document.hpp>
+#include <sngxml/dom/Element.hpp>
+#include <sngxml/dom/Parser.hpp>
+#include <soulng/rex/Match.hpp>
+#include <soulng/util/CodeFormatter.hpp>
+#include <soulng/util/Json.hpp>
+#include <soulng/util/Path.hpp>
+#include <soulng/util/Time.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <iomanip>
+#include <sstream>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+using namespace soulng::unicode;
+
+IndexEntry::IndexEntry(const std::string& component_, const std::string& path_, uintmax_t size_, std::time_t time_, const std::string& hash_) :
+    component(component_), path(path_), size(size_), time(time_), hash(hash_)
+{
+}
+
+void AddIndexEntries(const std::string& componentName, Directory* directory, std::vector<IndexEntry>& entries)
+{
+    for (const auto& childDirectory : directory->Directories())
+    {
+        AddIndexEntries(componentName, childDirectory.get(), entries);
+    }
+    for (const auto& file : directory->Files())
+    {
+        entries.push_back(IndexEntry(componentName, file->Path(), file->Size(), file->Time(), file->Hash()));
+    }
+}
+
+std::vector<IndexEntry> GetIndexEntries(Package* package)
+{
+    std::vector<IndexEntry> entries;
+    for (const auto& component : package->Components())
+    {
+        for (const auto& directory : component->Directories())
+        {
+            AddIndexEntries(component->Name(), directory.get(), entries);
+        }
+        for (const auto& file : component->Files())
+        {
+            entries.push_back(IndexEntry(component->Name(), file->Path(), file->Size(), file->Time(), file->Hash()));
+        }
+    }
+    return entries;
+}
+
+std::time_t ParseIndexTime(const std::string& timeStr)
+{
+    std::tm tm = {};
+    std::istringstream s(timeStr);
+    s >> std::get_time(&tm, "%d.%m.%Y %H:%M:%S");
+    if (s.fail())
+    {
+        throw std::runtime_error("invalid time '" + timeStr + "'");
+    }
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+void AddIndexEntries(const std::string& componentName, const std::string& path, sngxml::dom::Element* element, std::vector<IndexEntry>& entries)
+{
+    sngxml::dom::Node* child = element->FirstChild();
+    while (child)
+    {
+        if (child->GetNodeType() == sngxml::dom::NodeType::elementNode)
+        {
+            sngxml::dom::Element* childElement = static_cast<sngxml::dom::Element*>(child);
+            std::string name(childElement->GetAttribute("name"));
+            std::string childPath = path.empty() ? name : path + "/" + name;
+            if (childElement->Name() == U"directory")
+            {
+                AddIndexEntries(componentName, childPath, childElement, entries);
+            }
+            else if (childElement->Name() == U"file")
+            {
+                uintmax_t size = std::stoull(std::string(childElement->GetAttribute("size")));
+                std::time_t time = ParseIndexTime(std::string(childElement->GetAttribute("time")));
+                entries.push_back(IndexEntry(componentName, childPath, size, time, std::string(childElement->GetAttribute("hash"))));
+            }
+        }
+        child = child->NextSibling();
+    }
+}
+
+std::vector<IndexEntry> ReadIndexEntriesFromXmlFile(const std::string& xmlIndexFilePath)
+{
+    std::vector<IndexEntry> entries;
+    std::unique_ptr<sngxml::dom::Document> indexDoc = sngxml::dom::ReadDocument(xmlIndexFilePath, sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena | sngxml::dom::Flags::utf8);
+    sngxml::dom::Element* packageIndexElement = indexDoc->DocumentElement();
+    if (!packageIndexElement || packageIndexElement->Name() != U"packageIndex")
+    {
+        throw std::runtime_error("'packageIndex' root element expected in package index XML document '" + xmlIndexFilePath + "'");
+    }
+    sngxml::dom::Node* child = packageIndexElement->FirstChild();
+    while (child)
+    {
+        if (child->GetNodeType() == sngxml::dom::NodeType::elementNode)
+        {
+            sngxml::dom::Element* componentElement = static_cast<sngxml::dom::Element*>(child);
+            if (componentElement->Name() == U"component")
+            {
+                AddIndexEntries(std::string(componentElement->GetAttribute("name")), std::string(), componentElement, entries);
+            }
+        }
+        child = child->NextSibling();
+    }
+    return entries;
+}
+
+std::vector<IndexEntry> ReadIndexEntries(const std::string& filePath)
+{
+    if (Path::GetExtension(filePath) == ".xml")
+    {
+        return ReadIndexEntriesFromXmlFile(filePath);
+    }
+    else
+    {
+        std::unique_ptr<Package> package(new Package());
+        package->ReadPackageIndex(DataSource::file, filePath, nullptr, 0, Content::all);
+        return GetIndexEntries(package.get());
+    }
+}
+
+IndexFilter::IndexFilter()
+{
+}
+
+void IndexFilter::AddComponent(const std::string& componentName)
+{
+    components.insert(componentName);
+}
+
+void IndexFilter::AddPattern(const std::string& filePattern)
+{
+    patterns.push_back(context.GetFilePatternMatcher(ToUtf32(filePattern)));
+}
+
+bool IndexFilter::Include(const IndexEntry& entry)
+{
+    return IncludeComponent(entry.component) && IncludePath(entry.path);
+}
+
+bool IndexFilter::IncludeComponent(const std::string& componentName) const
+{
+    return components.empty() || components.find(componentName) != components.cend();
+}
+
+bool IndexFilter::IncludePath(const std::string& path)
+{
+    if (patterns.empty()) return true;
+    for (const auto& pattern : patterns)
+    {
+        if (pattern->Match(path))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ListPackageIndexAsText(Package* package, const std::vector<IndexEntry>& entries, std::ostream& stream)
+{
+    stream << "package '" << package->Name() << "' version " << package->Version() << ", compression " << CompressionStr(package->GetCompression()) <<
+        ", target root directory '" << package->TargetRootDir() << "'" << std::endl;
+    std::string componentName;
+    bool first = true;
+    uintmax_t totalSize = 0;
+    for (const IndexEntry& entry : entries)
+    {
+        if (first || entry.component != componentName)
+        {
+            first = false;
+            componentName = entry.component;
+            stream << "component '" << componentName << "'" << std::endl;
+        }
+        stream << std::setw(12) << entry.size << " " << TimeToString(entry.time) << " " << std::setw(40) << std::left << entry.hash << std::right << " " << entry.path << std::endl;
+        totalSize += entry.size;
+    }
+    stream << entries.size() << " files, " << totalSize << " bytes" << std::endl;
+}
+
+void ListPackageIndexAsJson(Package* package, const std::vector<IndexEntry>& entries, std::ostream& stream)
+{
+    JsonObject packageObject;
+    packageObject.AddField(U"name", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(package->Name()))));
+    packageObject.AddField(U"version", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(package->Version()))));
+    packageObject.AddField(U"compression", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(CompressionStr(package->GetCompression())))));
+    packageObject.AddField(U"targetRootDir", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(package->TargetRootDir()))));
+    std::unique_ptr<JsonArray> componentArray(new JsonArray());
+    std::unique_ptr<JsonObject> componentObject;
+    std::unique_ptr<JsonArray> fileArray;
+    std::string componentName;
+    uintmax_t totalSize = 0;
+    for (const IndexEntry& entry : entries)
+    {
+        if (!componentObject || entry.component != componentName)
+        {
+            if (componentObject)
+            {
+                componentObject->AddField(U"files", std::unique_ptr<JsonValue>(fileArray.release()));
+                componentArray->AddItem(std::unique_ptr<JsonValue>(componentObject.release()));
+            }
+            componentName = entry.component;
+            componentObject.reset(new JsonObject());
+            componentObject->AddField(U"name", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(componentName))));
+            fileArray.reset(new JsonArray());
+        }
+        std::unique_ptr<JsonObject> fileObject(new JsonObject());
+        fileObject->AddField(U"path", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(entry.path))));
+        fileObject->AddField(U"size", std::unique_ptr<JsonValue>(new JsonNumber(static_cast<double>(entry.size))));
+        fileObject->AddField(U"time", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(TimeToString(entry.time)))));
+        fileObject->AddField(U"hash", std::unique_ptr<JsonValue>(new JsonString(ToUtf32(entry.hash))));
+        fileArray->AddItem(std::unique_ptr<JsonValue>(fileObject.release()));
+        totalSize += entry.size;
+    }
+    if (componentObject)
+    {
+        componentObject->AddField(U"files", std::unique_ptr<JsonValue>(fileArray.release()));
+        componentArray->AddItem(std::unique_ptr<JsonValue>(componentObject.release()));
+    }
+    packageObject.AddField(U"components", std::unique_ptr<JsonValue>(componentArray.release()));
+    packageObject.AddField(U"fileCount", std::unique_ptr<JsonValue>(new JsonNumber(static_cast<double>(entries.size()))));
+    packageObject.AddField(U"totalSize", std::unique_ptr<JsonValue>(new JsonNumber(static_cast<double>(totalSize))));
+    CodeFormatter formatter(stream);
+    formatter.SetIndentSize(1);
+    packageObject.Write(formatter);
+}
+
+void ListPackageIndex(Package* package, IndexFilter& filter, ListFormat format, std::ostream& stream)
+{
+    std::vector<IndexEntry> entries;
+    for (const IndexEntry& entry : GetIndexEntries(package))
+    {
+        if (filter.Include(entry))
+        {
+            entries.push_back(entry);
+        }
+    }
+    switch (format)
+    {
+        case ListFormat::text:
+        {
+            ListPackageIndexAsText(package, entries, stream);
+            break;
+        }
+        case ListFormat::json:
+        {
+            ListPackageIndexAsJson(package, entries, stream);
+            break;
+        }
+    }
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,63 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_QUERY_INCLUDED
+#define WINGSTALL_WINGPACKAGE_QUERY_INCLUDED
+#include <wingpackage/api.hpp>
+#include <soulng/rex/Context.hpp>
+#include <soulng/rex/FilePattern.hpp>
+#include <soulng/rex/Nfa.hpp>
+#include <ctime>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace wingstall { namespace wingpackage {
+
+class Package;
+
+struct IndexEntry
+{
+    IndexEntry(const std::string& component_, const std::string& path_, uintmax_t size_, std::time_t time_, const std::string& hash_);
+    std::string component;
+    std::string path;
+    uintmax_t size;
+    std::time_t time;
+    std::string hash;
+};
+
+std::vector<IndexEntry> GetIndexEntries(Package* package);
+std::vector<IndexEntry> ReadIndexEntriesFromXmlFile(const std::string& xmlIndexFilePath);
+std::vector<IndexEntry> ReadIndexEntries(const std::string& filePath);
+
+class IndexFilter
+{
+public:
+    IndexFilter();
+    IndexFilter(const IndexFilter&) = delete;
+    IndexFilter& operator=(const IndexFilter&) = delete;
+    void AddComponent(const std::string& componentName);
+    void AddPattern(const std::string& filePattern);
+    bool Empty() const { return components.empty() && patterns.empty(); }
+    bool Include(const IndexEntry& entry);
+    bool IncludeComponent(const std::string& componentName) const;
+    bool IncludePath(const std::string& path);
+private:
+    soulng::rex::Context context;
+    std::set<std::string> components;
+    std::vector<std::shared_ptr<const soulng::rex::FilePatternMatcher>> patterns;
+};
+
+enum class ListFormat
+{
+    text, json
+};
+
+void ListPackageIndex(Package* package, IndexFilter& filter, ListFormat format, std::ostream& stream);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_QUERY_INCLUDED
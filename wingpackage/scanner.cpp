@@ -0,0 +1,252 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/scanner.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/snapshot.hpp>
+#include <soulng/util/Path.hpp>
+#include <boost/filesystem.hpp>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+ScanObserver::~ScanObserver()
+{
+}
+
+ScanTask::ScanTask() : directory(nullptr), element(nullptr)
+{
+}
+
+ScanTask::ScanTask(Directory* directory_, const std::string& path_, const std::shared_ptr<PathRuleSet>& parentRuleSet_, sngxml::dom::Element* element_) :
+    directory(directory_), path(path_), parentRuleSet(parentRuleSet_), element(element_)
+{
+}
+
+ThreadBudget::ThreadBudget(int numThreads_) : freeThreads(std::max(0, numThreads_))
+{
+}
+
+int ThreadBudget::Acquire(int count)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    int acquired = std::max(0, std::min(count, freeThreads));
+    freeThreads -= acquired;
+    return acquired;
+}
+
+void ThreadBudget::Release(int count)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    freeThreads += count;
+}
+
+void ScanQueue::Push(ScanTask&& task)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    tasks.push_back(std::move(task));
+}
+
+bool ScanQueue::Pop(ScanTask& task)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (tasks.empty()) return false;
+    task = std::move(tasks.back());
+    tasks.pop_back();
+    return true;
+}
+
+bool ScanQueue::Steal(ScanTask& task)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (tasks.empty()) return false;
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+}
+
+SourceScanner::SourceScanner(PathMatcher& pathMatcher_, int numThreads_) :
+    pathMatcher(pathMatcher_), numThreads(std::max(1, numThreads_)), pendingTasks(0), pushCount(0), running(false), stop(false)
+{
+    for (int i = 0; i < numThreads; ++i)
+    {
+        queues.push_back(std::unique_ptr<ScanQueue>(new ScanQueue()));
+    }
+}
+
+void SourceScanner::AddDirectory(Directory* directory, sngxml::dom::Element* element)
+{
+    AddDirectory(directory, Path::Combine(pathMatcher.CurrentDir(), directory->Name()), pathMatcher.CurrentRuleSet(), element);
+}
+
+void SourceScanner::AddDirectory(Directory* directory, const std::string& path, const std::shared_ptr<PathRuleSet>& parentRuleSet, sngxml::dom::Element* element)
+{
+    int index = static_cast<int>(pushCount % numThreads);
+    Push(index, ScanTask(directory, path, parentRuleSet, element));
+}
+
+void SourceScanner::Run()
+{
+    if (pendingTasks == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = true;
+        StartThreads();
+    }
+    RunThread(0);
+    std::vector<std::thread> startedThreads;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+        std::swap(startedThreads, threads);
+    }
+    for (std::thread& thread : startedThreads)
+    {
+        thread.join();
+    }
+    ThreadBudget* threadBudget = pathMatcher.GetThreadBudget();
+    if (threadBudget)
+    {
+        threadBudget->Release(static_cast<int>(startedThreads.size()));
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+// Called with the mutex locked. Starts extra threads while there are more pending tasks than running threads.
+
+void SourceScanner::StartThreads()
+{
+    ThreadBudget* threadBudget = pathMatcher.GetThreadBudget();
+    while (running && !stop && static_cast<int>(threads.size()) < numThreads - 1 && pendingTasks > static_cast<int64_t>(threads.size()) + 1)
+    {
+        if (threadBudget && threadBudget->Acquire(1) == 0) return;
+        int index = static_cast<int>(threads.size()) + 1;
+        threads.push_back(std::thread([this, index] { RunThread(index); }));
+    }
+}
+
+void SourceScanner::RunThread(int index)
+{
+    while (true)
+    {
+        int64_t seenPushCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (stop || pendingTasks == 0) return;
+            seenPushCount = pushCount;
+        }
+        ScanTask task;
+        if (GetTask(index, task))
+        {
+            try
+            {
+                Execute(index, task);
+            }
+            catch (...)
+            {
+                Fail(std::current_exception());
+            }
+            if (--pendingTasks == 0)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                stateChanged.notify_all();
+            }
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            stateChanged.wait(lock, [this, seenPushCount] { return stop || pendingTasks == 0 || pushCount != seenPushCount; });
+        }
+    }
+}
+
+bool SourceScanner::GetTask(int index, ScanTask& task)
+{
+    if (queues[index]->Pop(task)) return true;
+    for (int i = 1; i < numThreads; ++i)
+    {
+        if (queues[(index + i) % numThreads]->Steal(task)) return true;
+    }
+    return false;
+}
+
+void SourceScanner::Push(int index, ScanTask&& task)
+{
+    ++pendingTasks;
+    queues[index]->Push(std::move(task));
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ++pushCount;
+        StartThreads();
+    }
+    stateChanged.notify_one();
+}
+
+void SourceScanner::Execute(int index, ScanTask& task)
+{
+    Directory* directory = task.directory;
+    if (directory->Time() == std::time_t())
+    {
+        directory->SetTime(boost::filesystem::last_write_time(MakeNativeBoostPath(task.path)));
+    }
+    std::shared_ptr<PathRuleSet> ruleSet = MakeDirectoryRuleSet(pathMatcher, task.parentRuleSet, task.element);
+    ScanSnapshot* snapshot = pathMatcher.GetScanSnapshot();
+    DirectoryContent content;
+    bool reused = snapshot && snapshot->Get(task.path, directory->Time(), *ruleSet, content);
+    if (!reused)
+    {
+        content = ReadDirectory(task.path, *ruleSet);
+    }
+    if (snapshot)
+    {
+        snapshot->Put(task.path, directory->Time(), content);
+    }
+    for (const auto& directoryInfo : content.directories)
+    {
+        Directory* childDirectory = new Directory(directoryInfo.name, directoryInfo.time);
+        directory->AddDirectory(childDirectory);
+        Push(index, ScanTask(childDirectory, Path::Combine(task.path, directoryInfo.name), ruleSet, directoryInfo.element));
+    }
+    for (const auto& fileInfo : content.files)
+    {
+        File* file = new File();
+        file->SetName(fileInfo.name);
+        file->SetSize(fileInfo.size);
+        file->SetTime(fileInfo.time);
+        directory->AddFile(file);
+    }
+    ScanObserver* observer = pathMatcher.GetScanObserver();
+    if (observer)
+    {
+        observer->DirectoryScanned(directory, task.path, ruleSet);
+    }
+}
+
+void SourceScanner::Fail(std::exception_ptr ex)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!exception)
+        {
+            exception = ex;
+        }
+        stop = true;
+    }
+    stateChanged.notify_all();
+}
+
+// Enumerating a directory mostly waits for the file system, especially on network drives, so use more threads than there are processors.
+
+int DefaultScanThreadCount()
+{
+    return std::max(1, 2 * static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} } // namespace wingstall::wingpackage
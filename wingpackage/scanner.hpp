@@ -0,0 +1,103 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_SCANNER_INCLUDED
+#define WINGSTALL_WINGPACKAGE_SCANNER_INCLUDED
+#include <wingpackage/path_matcher.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace wingstall { namespace wingpackage {
+
+class Directory;
+
+struct ScanTask
+{
+    ScanTask();
+    ScanTask(Directory* directory_, const std::string& path_, const std::shared_ptr<PathRuleSet>& parentRuleSet_, sngxml::dom::Element* element_);
+    Directory* directory;
+    std::string path;
+    std::shared_ptr<PathRuleSet> parentRuleSet;
+    sngxml::dom::Element* element;
+};
+
+// Notified from the scanning threads after a directory has been enumerated, with the rule set that was used for its entries.
+
+class ScanObserver
+{
+public:
+    virtual ~ScanObserver();
+    virtual void DirectoryScanned(Directory* directory, const std::string& path, const std::shared_ptr<PathRuleSet>& ruleSet) = 0;
+};
+
+// Threads shared by the scanners of packages that are built concurrently. A scanner borrows a free thread each time it starts an extra thread
+// and returns them when it has finished, so the threads released by packages that have finished scanning go to the packages that scan later.
+
+class ThreadBudget
+{
+public:
+    ThreadBudget(int numThreads_);
+    int Acquire(int count);
+    void Release(int count);
+private:
+    std::mutex mtx;
+    int freeThreads;
+};
+
+class ScanQueue
+{
+public:
+    void Push(ScanTask&& task);
+    bool Pop(ScanTask& task);
+    bool Steal(ScanTask& task);
+private:
+    std::mutex mtx;
+    std::deque<ScanTask> tasks;
+};
+
+// Builds the directory trees of a component from the source directories. Every directory is a task that enumerates the directory,
+// adds its subdirectories and files to the Directory node and pushes a new task for each subdirectory.
+// A thread takes tasks from the back of its own queue and steals from the front of the queues of the other threads when its own queue is empty.
+// Each task carries the rule set chain of its parent directory, so tasks need no shared matching state.
+// The children of a directory are added by the single task that enumerated it, in enumeration order, so the resulting tree does not depend on the scheduling.
+// The calling thread runs tasks too. Extra threads, up to numThreads - 1, are started only while there are more pending tasks than running threads,
+// so a component with a few directories does not start threads that would have nothing to do.
+
+class SourceScanner
+{
+public:
+    SourceScanner(PathMatcher& pathMatcher_, int numThreads_);
+    void AddDirectory(Directory* directory, sngxml::dom::Element* element);
+    void AddDirectory(Directory* directory, const std::string& path, const std::shared_ptr<PathRuleSet>& parentRuleSet, sngxml::dom::Element* element);
+    void Run();
+private:
+    void RunThread(int index);
+    bool GetTask(int index, ScanTask& task);
+    void Push(int index, ScanTask&& task);
+    void StartThreads();
+    void Execute(int index, ScanTask& task);
+    void Fail(std::exception_ptr ex);
+    PathMatcher& pathMatcher;
+    int numThreads;
+    std::vector<std::unique_ptr<ScanQueue>> queues;
+    std::atomic<int64_t> pendingTasks;
+    std::mutex mtx;
+    std::condition_variable stateChanged;
+    int64_t pushCount;
+    bool running;
+    bool stop;
+    std::vector<std::thread> threads;
+    std::exception_ptr exception;
+};
+
+int DefaultScanThreadCount();
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_SCANNER_INCLUDED
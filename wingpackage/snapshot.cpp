@@ -0,0 +1,182 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/snapshot.hpp>
+#include <wing/FileUtil.hpp>
+#include <soulng/util/BinaryStreamReader.hpp>
+#include <soulng/util/BinaryStreamWriter.hpp>
+#include <soulng/util/BufferedStream.hpp>
+#include <soulng/util/ChecksumFrameStream.hpp>
+#include <soulng/util/FileStream.hpp>
+#include <soulng/util/MappedInputFile.hpp>
+#include <soulng/util/Path.hpp>
+#include <soulng/util/Sha1.hpp>
+#include <boost/filesystem.hpp>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+const std::string snapshotMagic = "WINGSTALL.SCAN";
+const uint8_t snapshotVersion = 1;
+
+SnapshotDirectory::SnapshotDirectory() : time()
+{
+}
+
+SnapshotDirectory::SnapshotDirectory(std::time_t time_, const DirectoryContent& content_) : time(time_), content(content_)
+{
+}
+
+ScanSnapshot::ScanSnapshot(const std::string& packageXmlFilePath) : filePath(Path::ChangeExtension(packageXmlFilePath, ".scan.bin")), reusedCount(0)
+{
+    std::string xml = ReadFile(packageXmlFilePath);
+    Sha1 sha1;
+    sha1.Process(const_cast<char*>(xml.data()), static_cast<int>(xml.size()));
+    key = sha1.GetDigest();
+}
+
+// A missing snapshot, a snapshot made from another version of the package XML document and a damaged snapshot are all ignored: every directory is then scanned.
+
+void ScanSnapshot::Load()
+{
+    previous.clear();
+    if (!boost::filesystem::exists(MakeNativeBoostPath(filePath))) return;
+    try
+    {
+        FileStream fileStream(filePath, OpenMode::read | OpenMode::binary);
+        BufferedStream bufferedStream(fileStream);
+        ChecksumFrameStream frameStream(FrameMode::read, bufferedStream);
+        BinaryStreamReader reader(frameStream);
+        std::string magic = reader.ReadUtf8String();
+        uint8_t version = reader.ReadByte();
+        if (magic != snapshotMagic || version != snapshotVersion) return;
+        std::string snapshotKey = reader.ReadUtf8String();
+        if (snapshotKey != key) return;
+        int32_t numDirectories = reader.ReadInt();
+        for (int32_t i = 0; i < numDirectories; ++i)
+        {
+            std::string directoryPath = reader.ReadUtf8String();
+            SnapshotDirectory& directory = previous[directoryPath];
+            directory.time = reader.ReadTime();
+            int32_t numSubdirectories = reader.ReadInt();
+            for (int32_t j = 0; j < numSubdirectories; ++j)
+            {
+                std::string name = reader.ReadUtf8String();
+                std::time_t time = reader.ReadTime();
+                directory.content.directories.push_back(DirectoryInfo(name, time, nullptr));
+            }
+            int32_t numFiles = reader.ReadInt();
+            for (int32_t j = 0; j < numFiles; ++j)
+            {
+                std::string name = reader.ReadUtf8String();
+                uint64_t size = reader.ReadULong();
+                std::time_t time = reader.ReadTime();
+                directory.content.files.push_back(FileInfo(name, size, time));
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        previous.clear();
+    }
+}
+
+// Saves the directories scanned or reused during this build. The snapshot is written to a temporary file first, so a failed save leaves the previous snapshot intact.
+
+void ScanSnapshot::Save()
+{
+    std::string tempFilePath = filePath + ".tmp";
+    {
+        FileStream fileStream(tempFilePath, OpenMode::write | OpenMode::binary);
+        BufferedStream bufferedStream(fileStream);
+        {
+            ChecksumFrameStream frameStream(FrameMode::write, bufferedStream);
+            BinaryStreamWriter writer(frameStream);
+            writer.Write(snapshotMagic);
+            writer.Write(snapshotVersion);
+            writer.Write(key);
+            writer.Write(static_cast<int32_t>(current.size()));
+            for (const auto& p : current)
+            {
+                const SnapshotDirectory& directory = p.second;
+                writer.Write(p.first);
+                writer.WriteTime(directory.time);
+                writer.Write(static_cast<int32_t>(directory.content.directories.size()));
+                for (const auto& directoryInfo : directory.content.directories)
+                {
+                    writer.Write(directoryInfo.name);
+                    writer.WriteTime(directoryInfo.time);
+                }
+                writer.Write(static_cast<int32_t>(directory.content.files.size()));
+                for (const auto& fileInfo : directory.content.files)
+                {
+                    writer.Write(fileInfo.name);
+                    writer.Write(static_cast<uint64_t>(fileInfo.size));
+                    writer.WriteTime(fileInfo.time);
+                }
+            }
+            frameStream.Finish();
+        }
+        bufferedStream.Flush();
+    }
+    boost::filesystem::rename(MakeNativeBoostPath(tempFilePath), MakeNativeBoostPath(filePath));
+}
+
+// Called from the scanning threads. The previous snapshot is not modified after it has been loaded, so it can be read without locking.
+// Subdirectory elements are not stored in the snapshot but looked up from the rule set of the directory.
+// The last write time of a directory does not change when a file in it is modified in place, so the directory is enumerated again in one pass
+// to get the current size and time of each entry. Only the rule verdicts are taken from the snapshot. If an entry of the snapshot is no longer there,
+// the snapshot is not used for the directory.
+
+bool ScanSnapshot::Get(const std::string& directoryPath, std::time_t time, const PathRuleSet& ruleSet, DirectoryContent& content) const
+{
+    if (time == std::time_t()) return false;
+    auto it = previous.find(directoryPath);
+    if (it == previous.cend() || it->second.time != time) return false;
+    std::vector<wing::DirectoryEntry> entries;
+    try
+    {
+        entries = wing::ReadDirectory(directoryPath);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    std::unordered_map<std::string, const wing::DirectoryEntry*> entryMap;
+    for (const wing::DirectoryEntry& entry : entries)
+    {
+        entryMap[entry.name] = &entry;
+    }
+    content = it->second.content;
+    for (auto& fileInfo : content.files)
+    {
+        auto entryIt = entryMap.find(fileInfo.name);
+        if (entryIt == entryMap.cend() || entryIt->second->kind != wing::DirectoryEntryKind::file) return false;
+        fileInfo.size = entryIt->second->size;
+        fileInfo.time = entryIt->second->time;
+    }
+    for (auto& directoryInfo : content.directories)
+    {
+        auto entryIt = entryMap.find(directoryInfo.name);
+        if (entryIt == entryMap.cend() || entryIt->second->kind != wing::DirectoryEntryKind::directory) return false;
+        directoryInfo.time = entryIt->second->time;
+        PathRule* rule = ruleSet.GetRule(directoryInfo.name);
+        if (rule)
+        {
+            directoryInfo.element = rule->GetElement();
+        }
+    }
+    ++reusedCount;
+    return true;
+}
+
+void ScanSnapshot::Put(const std::string& directoryPath, std::time_t time, const DirectoryContent& content)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    current[directoryPath] = SnapshotDirectory(time, content);
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,51 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_SNAPSHOT_INCLUDED
+#define WINGSTALL_WINGPACKAGE_SNAPSHOT_INCLUDED
+#include <wingpackage/path_matcher.hpp>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace wingstall { namespace wingpackage {
+
+struct SnapshotDirectory
+{
+    SnapshotDirectory();
+    SnapshotDirectory(std::time_t time_, const DirectoryContent& content_);
+    std::time_t time;
+    DirectoryContent content;
+};
+
+// Remembers the included subdirectories and files of each scanned directory between package builds.
+// A snapshot is valid only for the package XML document it was made from: it is keyed by the SHA-1 digest of the document.
+// The entries of a directory are taken from the snapshot if the last write time of the directory has not changed since the snapshot was made.
+// The last write time of a directory changes when entries are added, removed or renamed, but not when the content of a file changes,
+// so only the rule verdicts are reused: a reused directory is enumerated again in one pass to get the current size and time of each entry.
+
+class ScanSnapshot
+{
+public:
+    ScanSnapshot(const std::string& packageXmlFilePath);
+    const std::string& FilePath() const { return filePath; }
+    void Load();
+    void Save();
+    bool Get(const std::string& directoryPath, std::time_t time, const PathRuleSet& ruleSet, DirectoryContent& content) const;
+    void Put(const std::string& directoryPath, std::time_t time, const DirectoryContent& content);
+    int64_t ReusedCount() const { return reusedCount; }
+    int64_t DirectoryCount() const { return current.size(); }
+private:
+    std::string filePath;
+    std::string key;
+    std::unordered_map<std::string, SnapshotDirectory> previous;
+    std::mutex mtx;
+    std::unordered_map<std::string, SnapshotDirectory> current;
+    mutable std::atomic<int64_t> reusedCount;
+};
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_SNAPSHOT_INCLUDED
@@ -5,6 +5,7 @@
 
 #include <wingpackage/uninstall_bin_file.hpp>
 #include <wingpackage/package.hpp>
+#include <wingpackage/data_visitor.hpp>
 #include <soulng/util/BinaryReader.hpp>
 #include <soulng/util/FileStream.hpp>
 #include <soulng/util/BufferedStream.hpp>
@@ -37,6 +38,10 @@ void UninstallBinFile::ReadData(BinaryStreamReader& reader)
 {
 }
 
+void UninstallBinFile::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+}
+
 void UninstallBinFile::Uninstall()
 {
     Package* package = GetPackage();
@@ -17,6 +17,7 @@ public:
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
     void Uninstall() override;
 private:
     void Remove();
@@ -87,6 +87,14 @@ void UninstallComponent::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void UninstallComponent::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    for (const auto& file : files)
+    {
+        file->VisitData(reader, visitor);
+    }
+}
+
 void UninstallComponent::Uninstall()
 {
     Package* package = GetPackage();
@@ -15,10 +15,12 @@ public:
     UninstallComponent();
     void Initialize();
     void AddFile(File* file);
+    const std::vector<std::unique_ptr<File>>& Files() const override { return files; }
     void WriteIndex(BinaryStreamWriter& writer) override;
     void ReadIndex(BinaryStreamReader& reader) override;
     void WriteData(BinaryStreamWriter& writer) override;
     void ReadData(BinaryStreamReader& reader) override;
+    void VisitData(BinaryStreamReader& reader, DataVisitor& visitor) override;
     void Uninstall() override;
 private:
     std::vector<std::unique_ptr<File>> files;
@@ -5,6 +5,7 @@
 
 #include <wingpackage/uninstall_exe_file.hpp>
 #include <wingpackage/package.hpp>
+#include <wingpackage/data_visitor.hpp>
 #include <wing/FileUtil.hpp>
 #include <soulng/util/BinaryReader.hpp>
 #include <soulng/util/FileStream.hpp>
@@ -97,6 +98,12 @@ void UninstallExeFile::ReadData(BinaryStreamReader& reader)
     }
 }
 
+void UninstallExeFile::VisitData(BinaryStreamReader& reader, DataVisitor& visitor)
+{
+    if (visitor.Done()) return;
+    visitor.VisitFileData(this, reader, false);
+}
+
 void UninstallExeFile::Uninstall()
 {
     Package* package = GetPackage();
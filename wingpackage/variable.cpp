@@ -28,12 +28,12 @@ std::string Variable::Value() const
     return std::string();
 }
 
-sngxml::dom::Element* Variable::ToXml() const
+void Variable::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"variable");
-    element->SetAttribute(U"name", ToUtf32(Name()));
-    element->SetAttribute(U"value", ToUtf32(Value()));
-    return element;
+    writer.StartElement("variable");
+    writer.Attribute("name", Name());
+    writer.Attribute("value", Value());
+    writer.EndElement();
 }
 
 TargetRootDirVariable::TargetRootDirVariable() : Variable("TARGET_ROOT_DIR")
@@ -219,15 +219,14 @@ Variable* Variables::GetVariable(const std::string& name) const
     }
 }
 
-sngxml::dom::Element* Variables::ToXml() const
+void Variables::WriteXml(sngxml::xml::XmlWriter& writer) const
 {
-    sngxml::dom::Element* element = new sngxml::dom::Element(U"variables");
+    writer.StartElement("variables");
     for (const auto& variable : variables)
     {
-        sngxml::dom::Element* child = variable->ToXml();
-        element->AppendChild(std::unique_ptr<sngxml::dom::Node>(child));
+        variable->WriteXml(writer);
     }
-    return element;
+    writer.EndElement();
 }
 
 std::string Variables::ExpandPath(const std::string& path) const
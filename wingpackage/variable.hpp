@@ -16,7 +16,7 @@ public:
     Variable();
     Variable(const std::string& name_);
     virtual std::string Value() const;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
 private:
     std::string name;
 };
@@ -91,7 +91,7 @@ public:
     void AddVariable(Variable* variable);
     Variable* GetVariable(const std::string& name) const;
     std::string ExpandPath(const std::string& path) const;
-    sngxml::dom::Element* ToXml() const override;
+    void WriteXml(sngxml::xml::XmlWriter& writer) const override;
 private:
     std::map<std::string, Variable*> variableMap;
     std::vector<std::unique_ptr<Variable>> variables;
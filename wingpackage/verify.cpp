@@ -0,0 +1,246 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/verify.hpp>
+#include <wingpackage/component.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/environment.hpp>
+#include <wingpackage/links.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace wingstall { namespace wingpackage {
+
+const int64_t hashChunkSize = 1024 * 1024;
+const int64_t maxQueuedBytesPerWorker = 16 * hashChunkSize;
+
+VerifyFailure::VerifyFailure(const std::string& path_, const std::string& expectedHash_, const std::string& computedHash_) :
+    path(path_), expectedHash(expectedHash_), computedHash(computedHash_)
+{
+}
+
+HashChunk::HashChunk() : file(nullptr), last(false)
+{
+}
+
+HashWorker::HashWorker(int64_t maxQueuedBytes_) : queuedBytes(0), maxQueuedBytes(maxQueuedBytes_), stop(false), verifiedCount(0)
+{
+}
+
+void HashWorker::Run()
+{
+    while (true)
+    {
+        HashChunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            queueChanged.wait(lock, [this] { return !queue.empty() || stop; });
+            if (queue.empty())
+            {
+                return;
+            }
+            chunk = std::move(queue.front());
+            queue.pop_front();
+            queuedBytes -= chunk.data.size();
+        }
+        queueChanged.notify_all();
+        if (!chunk.data.empty())
+        {
+            sha1.Process(chunk.data.data(), static_cast<int>(chunk.data.size()));
+        }
+        if (chunk.last)
+        {
+            std::string computedHash = sha1.GetDigest();
+            sha1.Reset();
+            if (computedHash == chunk.expectedHash)
+            {
+                ++verifiedCount;
+            }
+            else
+            {
+                failures.push_back(VerifyFailure(chunk.file->Path(), chunk.expectedHash, computedHash));
+            }
+        }
+    }
+}
+
+void HashWorker::Put(HashChunk&& chunk)
+{
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        queueChanged.wait(lock, [this] { return queuedBytes < maxQueuedBytes; });
+        queuedBytes += chunk.data.size();
+        queue.push_back(std::move(chunk));
+    }
+    queueChanged.notify_all();
+}
+
+void HashWorker::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    queueChanged.notify_all();
+}
+
+int64_t HashWorker::QueuedBytes()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return queuedBytes;
+}
+
+VerifyDataVisitor::VerifyDataVisitor(int numWorkers) : fileCount(0), byteCount(0)
+{
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::unique_ptr<HashWorker>(new HashWorker(maxQueuedBytesPerWorker)));
+    }
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        HashWorker* worker = workers[i].get();
+        threads.push_back(std::thread([worker] { worker->Run(); }));
+    }
+}
+
+VerifyDataVisitor::~VerifyDataVisitor()
+{
+    Finish();
+}
+
+void VerifyDataVisitor::Finish()
+{
+    for (const auto& worker : workers)
+    {
+        worker->Stop();
+    }
+    for (std::thread& thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+HashWorker* VerifyDataVisitor::SelectWorker()
+{
+    HashWorker* selected = nullptr;
+    int64_t minQueuedBytes = 0;
+    for (const auto& worker : workers)
+    {
+        int64_t queuedBytes = worker->QueuedBytes();
+        if (!selected || queuedBytes < minQueuedBytes)
+        {
+            selected = worker.get();
+            minQueuedBytes = queuedBytes;
+        }
+    }
+    return selected;
+}
+
+void VerifyDataVisitor::VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash)
+{
+    if (!hasHash)
+    {
+        SkipBytes(reader, file->Size());
+        return;
+    }
+    HashWorker* worker = SelectWorker();
+    Stream& stream = reader.GetStream();
+    int64_t count = file->Size();
+    while (count > 0)
+    {
+        HashChunk chunk;
+        chunk.file = file;
+        chunk.data.resize(std::min(count, hashChunkSize));
+        int64_t offset = 0;
+        while (offset < static_cast<int64_t>(chunk.data.size()))
+        {
+            int64_t n = stream.Read(chunk.data.data() + offset, chunk.data.size() - offset);
+            if (n <= 0)
+            {
+                throw std::runtime_error("unexpected end of package data stream while reading file '" + file->Path() + "'");
+            }
+            offset += n;
+        }
+        count -= chunk.data.size();
+        byteCount += chunk.data.size();
+        worker->Put(std::move(chunk));
+    }
+    HashChunk lastChunk;
+    lastChunk.file = file;
+    lastChunk.last = true;
+    lastChunk.expectedHash = reader.ReadUtf8String();
+    worker->Put(std::move(lastChunk));
+    ++fileCount;
+}
+
+int64_t VerifyDataVisitor::VerifiedCount() const
+{
+    int64_t verifiedCount = 0;
+    for (const auto& worker : workers)
+    {
+        verifiedCount += worker->VerifiedCount();
+    }
+    return verifiedCount;
+}
+
+std::vector<VerifyFailure> VerifyDataVisitor::Failures() const
+{
+    std::vector<VerifyFailure> failures;
+    for (const auto& worker : workers)
+    {
+        failures.insert(failures.end(), worker->Failures().begin(), worker->Failures().end());
+    }
+    return failures;
+}
+
+PackageVerification::PackageVerification() : fileCount(0), verifiedCount(0), byteCount(0), seconds(0)
+{
+}
+
+PackageVerification VerifyPackage(const std::string& packageFilePath, Content content)
+{
+    if ((content & Content::data) == Content::none)
+    {
+        throw std::runtime_error("package content does not include data");
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<Package> package(new Package());
+    Streams streams = package->ReadPackageIndex(DataSource::file, packageFilePath, nullptr, 0, content);
+    int numWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    VerifyDataVisitor visitor(numWorkers);
+    BinaryStreamReader reader(streams.Back());
+    package->VisitData(reader, visitor);
+    visitor.Finish();
+    PackageVerification verification;
+    verification.fileCount = visitor.FileCount();
+    verification.verifiedCount = visitor.VerifiedCount();
+    verification.byteCount = visitor.ByteCount();
+    verification.failures = visitor.Failures();
+    auto end = std::chrono::steady_clock::now();
+    verification.seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+    return verification;
+}
+
+void PrintPackageVerification(const std::string& packageFilePath, const PackageVerification& verification, std::ostream& stream)
+{
+    for (const VerifyFailure& failure : verification.failures)
+    {
+        stream << "FAILED " << failure.path << ": expected digest " << failure.expectedHash << ", computed digest " << failure.computedHash << std::endl;
+    }
+    double megabytes = verification.byteCount / (1024.0 * 1024.0);
+    double throughput = 0;
+    if (verification.seconds > 0)
+    {
+        throughput = megabytes / verification.seconds;
+    }
+    stream << "package '" << packageFilePath << "': " << verification.verifiedCount << " of " << verification.fileCount << " files verified, " <<
+        verification.failures.size() << " failed, " << verification.byteCount << " bytes in " << verification.seconds << " seconds (" << throughput << " MB/s)" << std::endl;
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,94 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_VERIFY_INCLUDED
+#define WINGSTALL_WINGPACKAGE_VERIFY_INCLUDED
+#include <wingpackage/data_visitor.hpp>
+#include <wingpackage/package.hpp>
+#include <soulng/util/Sha1.hpp>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace wingstall { namespace wingpackage {
+
+struct VerifyFailure
+{
+    VerifyFailure(const std::string& path_, const std::string& expectedHash_, const std::string& computedHash_);
+    std::string path;
+    std::string expectedHash;
+    std::string computedHash;
+};
+
+struct HashChunk
+{
+    HashChunk();
+    File* file;
+    std::vector<uint8_t> data;
+    bool last;
+    std::string expectedHash;
+};
+
+class HashWorker
+{
+public:
+    HashWorker(int64_t maxQueuedBytes_);
+    void Run();
+    void Put(HashChunk&& chunk);
+    void Stop();
+    int64_t QueuedBytes();
+    int64_t VerifiedCount() const { return verifiedCount; }
+    const std::vector<VerifyFailure>& Failures() const { return failures; }
+private:
+    std::mutex mtx;
+    std::condition_variable queueChanged;
+    std::list<HashChunk> queue;
+    int64_t queuedBytes;
+    int64_t maxQueuedBytes;
+    bool stop;
+    Sha1 sha1;
+    int64_t verifiedCount;
+    std::vector<VerifyFailure> failures;
+};
+
+// Reads the package data stream on the calling thread and hands the file contents chunk by chunk to hash workers running on other threads.
+// Each file is hashed by a single worker, so its chunks are processed in order.
+
+class VerifyDataVisitor : public DataVisitor
+{
+public:
+    VerifyDataVisitor(int numWorkers);
+    ~VerifyDataVisitor();
+    void VisitFileData(File* file, BinaryStreamReader& reader, bool hasHash) override;
+    void Finish();
+    int64_t FileCount() const { return fileCount; }
+    int64_t ByteCount() const { return byteCount; }
+    int64_t VerifiedCount() const;
+    std::vector<VerifyFailure> Failures() const;
+private:
+    HashWorker* SelectWorker();
+    std::vector<std::unique_ptr<HashWorker>> workers;
+    std::vector<std::thread> threads;
+    int64_t fileCount;
+    int64_t byteCount;
+};
+
+struct PackageVerification
+{
+    PackageVerification();
+    int64_t fileCount;
+    int64_t verifiedCount;
+    int64_t byteCount;
+    double seconds;
+    std::vector<VerifyFailure> failures;
+};
+
+PackageVerification VerifyPackage(const std::string& packageFilePath, Content content);
+void PrintPackageVerification(const std::string& packageFilePath, const PackageVerification& verification, std::ostream& stream);
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_VERIFY_INCLUDED
@@ -0,0 +1,268 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <wingpackage/watch.hpp>
+#include <wingpackage/directory.hpp>
+#include <wingpackage/file.hpp>
+#include <wingpackage/environment.hpp>
+#include <wingpackage/links.hpp>
+#include <wing/DirectoryWatcher.hpp>
+#include <sngxml/dom/Parser.hpp>
+#include <soulng/util/Path.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace wingstall { namespace wingpackage {
+
+using namespace soulng::util;
+
+const int pollMilliseconds = 1000;
+const int settleMilliseconds = 500;
+
+WatchedDirectory::WatchedDirectory() : directory(nullptr)
+{
+}
+
+WatchedDirectory::WatchedDirectory(Directory* directory_, const std::shared_ptr<PathRuleSet>& ruleSet_) : directory(directory_), ruleSet(ruleSet_)
+{
+}
+
+PackageWatcher::PackageWatcher(const std::string& packageXmlFilePath_, Content content_, bool verbose_) :
+    packageXmlFilePath(packageXmlFilePath_), content(content_), verbose(verbose_), packageXmlFileTime()
+{
+    outputFilePaths.insert(Path::ChangeExtension(packageXmlFilePath, ".bin"));
+    outputFilePaths.insert(Path::ChangeExtension(packageXmlFilePath, ".index.xml"));
+    outputFilePaths.insert(Path::ChangeExtension(packageXmlFilePath, ".info.xml"));
+}
+
+// A change reported for a watched directory, such as a new entry in it, updates that directory. A change to any other entry updates its parent directory.
+// An entry of the source root directory that is not a watched directory may be a new or a removed directory of a component, so it causes a full rebuild.
+
+void PackageWatcher::Run()
+{
+    Build();
+    CreatePackage();
+    std::unique_ptr<wing::DirectoryWatcher> watcher(new wing::DirectoryWatcher(pathMatcher->SourceRootDir()));
+    std::cout << "watching directory '" << watcher->DirectoryPath() << "'..." << std::endl;
+    bool rebuild = false;
+    while (true)
+    {
+        wing::DirectoryChanges changes;
+        if (!watcher->WaitForChanges(pollMilliseconds, changes))
+        {
+            if (!rebuild && PackageXmlFileTime() == packageXmlFileTime)
+            {
+                continue;
+            }
+            rebuild = true;
+        }
+        while (watcher->WaitForChanges(settleMilliseconds, changes))
+        {
+            // collect changes until there has been no change for settleMilliseconds
+        }
+        if (changes.overflow || PackageXmlFileTime() != packageXmlFileTime)
+        {
+            rebuild = true;
+        }
+        std::set<std::string> changedDirectoryPaths;
+        for (const std::string& path : changes.paths)
+        {
+            std::string fullPath = Path::Combine(watcher->DirectoryPath(), path);
+            if (outputFilePaths.find(fullPath) != outputFilePaths.cend()) continue;
+            bool isWatchedDirectory = watchedDirectories.find(fullPath) != watchedDirectories.cend() && boost::filesystem::is_directory(MakeNativeBoostPath(fullPath));
+            if (isWatchedDirectory)
+            {
+                changedDirectoryPaths.insert(fullPath);
+            }
+            std::string directoryPath = Path::GetDirectoryName(fullPath);
+            if (directoryPath == watcher->DirectoryPath())
+            {
+                if (!isWatchedDirectory)
+                {
+                    rebuild = true;
+                }
+            }
+            else
+            {
+                changedDirectoryPaths.insert(directoryPath);
+            }
+        }
+        if (!rebuild && changedDirectoryPaths.empty()) continue;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            if (rebuild)
+            {
+                Build();
+            }
+            else
+            {
+                Update(changedDirectoryPaths);
+            }
+            CreatePackage();
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+            std::cout << (rebuild ? "package rebuilt" : "package updated") << " in " << seconds << " seconds" << std::endl;
+            rebuild = false;
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << "package update failed: " << ex.what() << std::endl;
+            rebuild = true;
+        }
+        if (package && pathMatcher->SourceRootDir() != watcher->DirectoryPath())
+        {
+            watcher.reset(new wing::DirectoryWatcher(pathMatcher->SourceRootDir()));
+            std::cout << "watching directory '" << watcher->DirectoryPath() << "'..." << std::endl;
+        }
+    }
+}
+
+void PackageWatcher::DirectoryScanned(Directory* directory, const std::string& path, const std::shared_ptr<PathRuleSet>& ruleSet)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    watchedDirectories[path] = WatchedDirectory(directory, ruleSet);
+}
+
+void PackageWatcher::Build()
+{
+    if (verbose)
+    {
+        std::cout << "scanning package '" << packageXmlFilePath << "'..." << std::endl;
+    }
+    package.reset();
+    watchedDirectories.clear();
+    packageXmlFileTime = PackageXmlFileTime();
+    packageDoc = sngxml::dom::ReadDocument(packageXmlFilePath, sngxml::dom::Flags::streaming | sngxml::dom::Flags::arena | sngxml::dom::Flags::utf8);
+    pathMatcher.reset(new PathMatcher(packageXmlFilePath));
+    pathMatcher->SetScanObserver(this);
+    package.reset(new Package(*pathMatcher, packageDoc.get()));
+}
+
+void PackageWatcher::Update(const std::set<std::string>& changedDirectoryPaths)
+{
+    for (const std::string& directoryPath : changedDirectoryPaths)
+    {
+        if (verbose)
+        {
+            std::cout << "changed: " << directoryPath << std::endl;
+        }
+        UpdateDirectory(directoryPath);
+    }
+}
+
+// Parent directories sort before their subdirectories, so a removed subdirectory is no longer watched when its own changes are processed,
+// and a new subdirectory has already been scanned in full.
+
+void PackageWatcher::UpdateDirectory(const std::string& directoryPath)
+{
+    auto it = watchedDirectories.find(directoryPath);
+    if (it == watchedDirectories.cend()) return;
+    Directory* directory = it->second.directory;
+    std::shared_ptr<PathRuleSet> ruleSet = it->second.ruleSet;
+    if (!boost::filesystem::exists(MakeNativeBoostPath(directoryPath))) return;
+    DirectoryContent directoryContent = ReadDirectory(directoryPath, *ruleSet);
+    std::map<std::string, std::unique_ptr<File>> oldFiles;
+    for (auto& file : directory->ReleaseFiles())
+    {
+        std::string name = file->Name();
+        oldFiles[name] = std::move(file);
+    }
+    for (const auto& fileInfo : directoryContent.files)
+    {
+        File* file = nullptr;
+        auto fileIt = oldFiles.find(fileInfo.name);
+        if (fileIt != oldFiles.cend())
+        {
+            file = fileIt->second.release();
+        }
+        else
+        {
+            file = new File();
+            file->SetName(fileInfo.name);
+        }
+        file->SetSize(fileInfo.size);
+        file->SetTime(fileInfo.time);
+        file->SetHash(std::string());
+        directory->AddFile(file);
+    }
+    std::map<std::string, std::unique_ptr<Directory>> oldDirectories;
+    for (auto& childDirectory : directory->ReleaseDirectories())
+    {
+        std::string name = childDirectory->Name();
+        oldDirectories[name] = std::move(childDirectory);
+    }
+    SourceScanner scanner(*pathMatcher, DefaultScanThreadCount());
+    for (const auto& directoryInfo : directoryContent.directories)
+    {
+        auto directoryIt = oldDirectories.find(directoryInfo.name);
+        if (directoryIt != oldDirectories.cend())
+        {
+            Directory* childDirectory = directoryIt->second.release();
+            childDirectory->SetTime(directoryInfo.time);
+            directory->AddDirectory(childDirectory);
+        }
+        else
+        {
+            Directory* childDirectory = new Directory(directoryInfo.name, directoryInfo.time);
+            directory->AddDirectory(childDirectory);
+            scanner.AddDirectory(childDirectory, Path::Combine(directoryPath, directoryInfo.name), ruleSet, directoryInfo.element);
+        }
+    }
+    for (const auto& oldDirectory : oldDirectories)
+    {
+        if (oldDirectory.second)
+        {
+            RemoveWatchedDirectories(Path::Combine(directoryPath, oldDirectory.first));
+        }
+    }
+    scanner.Run();
+}
+
+void PackageWatcher::RemoveWatchedDirectories(const std::string& directoryPath)
+{
+    std::string prefix = directoryPath + "/";
+    auto it = watchedDirectories.lower_bound(directoryPath);
+    while (it != watchedDirectories.end() && (it->first == directoryPath || it->first.compare(0, prefix.length(), prefix) == 0))
+    {
+        it = watchedDirectories.erase(it);
+    }
+}
+
+void PackageWatcher::CreatePackage()
+{
+    std::string packageBinFilePath = Path::ChangeExtension(packageXmlFilePath, ".bin");
+    package->Create(packageBinFilePath, content);
+    if (verbose)
+    {
+        std::cout << "==> " << packageBinFilePath << std::endl;
+    }
+    std::string xmlIndexFilePath = Path::ChangeExtension(packageXmlFilePath, ".index.xml");
+    package->WriteIndexToXmlFile(xmlIndexFilePath);
+    if (verbose)
+    {
+        std::cout << "==> " << xmlIndexFilePath << std::endl;
+    }
+    std::string xmlInfoFilePath = Path::ChangeExtension(packageXmlFilePath, ".info.xml");
+    package->WriteInfoXmlFile(xmlInfoFilePath);
+    if (verbose)
+    {
+        std::cout << "==> " << xmlInfoFilePath << std::endl;
+    }
+}
+
+std::time_t PackageWatcher::PackageXmlFileTime() const
+{
+    boost::system::error_code ec;
+    std::time_t time = boost::filesystem::last_write_time(MakeNativeBoostPath(packageXmlFilePath), ec);
+    if (ec)
+    {
+        return std::time_t();
+    }
+    return time;
+}
+
+} } // namespace wingstall::wingpackage
@@ -0,0 +1,58 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#ifndef WINGSTALL_WINGPACKAGE_WATCH_INCLUDED
+#define WINGSTALL_WINGPACKAGE_WATCH_INCLUDED
+#include <wingpackage/package.hpp>
+#include <wingpackage/scanner.hpp>
+#include <sngxml/dom/Document.hpp>
+#include <map>
+#include <set>
+
+namespace wingstall { namespace wingpackage {
+
+struct WatchedDirectory
+{
+    WatchedDirectory();
+    WatchedDirectory(Directory* directory_, const std::shared_ptr<PathRuleSet>& ruleSet_);
+    Directory* directory;
+    std::shared_ptr<PathRuleSet> ruleSet;
+};
+
+// Builds a package once and then keeps its directory tree up to date by watching the source root directory for changes.
+// After each batch of changes only the changed directories are enumerated again with the rule set they were scanned with, and the package files are written again.
+// There is no hash cache by design: the content of every file is read and hashed again each time the package is written, because a file can change
+// without changing its size and time, and the bytes are read anyway to write them to the package.
+// A change in the package XML file, an entry of the source root directory that is not a watched directory or more changes than the system could report
+// cause a full rebuild.
+
+class PackageWatcher : public ScanObserver
+{
+public:
+    PackageWatcher(const std::string& packageXmlFilePath_, Content content_, bool verbose_);
+    void Run();
+    void DirectoryScanned(Directory* directory, const std::string& path, const std::shared_ptr<PathRuleSet>& ruleSet) override;
+private:
+    void Build();
+    void Update(const std::set<std::string>& changedDirectoryPaths);
+    void UpdateDirectory(const std::string& directoryPath);
+    void RemoveWatchedDirectories(const std::string& directoryPath);
+    void CreatePackage();
+    std::time_t PackageXmlFileTime() const;
+    std::string packageXmlFilePath;
+    Content content;
+    bool verbose;
+    std::unique_ptr<sngxml::dom::Document> packageDoc;
+    std::unique_ptr<PathMatcher> pathMatcher;
+    std::unique_ptr<Package> package;
+    std::mutex mtx;
+    std::map<std::string, WatchedDirectory> watchedDirectories;
+    std::set<std::string> outputFilePaths;
+    std::time_t packageXmlFileTime;
+};
+
+} } // namespace wingstall::wingpackage
+
+#endif // WINGSTALL_WINGPACKAGE_WATCH_INCLUDED
@@ -4,8 +4,14 @@
 // =================================
 
 #include <wingpackage/package.hpp>
+#include <wingpackage/batch.hpp>
 #include <wingpackage/path_matcher.hpp>
 #include <wingpackage/make_setup.hpp>
+#include <wingpackage/query.hpp>
+#include <wingpackage/diff.hpp>
+#include <wingpackage/extract.hpp>
+#include <wingpackage/verify.hpp>
+#include <wingpackage/watch.hpp>
 #include <wing/InitDone.hpp>
 #include <wing/Environment.hpp>
 #include <sngxml/xpath/InitDone.hpp>
@@ -35,7 +41,7 @@ using namespace wingstall::wingpackage;
 
 enum class Command
 {
-    none, createPackage, installPackage, makeSetup, installPackageFromVector, setCompression, setContent
+    none, createPackage, installPackage, makeSetup, installPackageFromVector, setCompression, setContent, listPackage, setComponentFilter, setFileFilter, diffPackages, extractFiles, setOutputDir, verifyPackage, watchPackage, setJobs
 };
 
 std::string WingstallVersionStr()
@@ -54,8 +60,33 @@ void PrintHelp()
     std::cout << "  Print help and exit." << std::endl;
     std::cout << "--create-package (-c) PACKAGE.package.xml" << std::endl;
     std::cout << "  Create binary package PACKAGE.package.bin, package info file PACKAGE.package.info.xml and package index PACKAGE.index.xml from package description file PACKAGE.package.xml." << std::endl;
+    std::cout << "--snapshot" << std::endl;
+    std::cout << "  With --create-package: take the included entries of each directory whose last write time has not changed from scan snapshot PACKAGE.scan.bin made by the previous build," << std::endl;
+    std::cout << "  and save a new snapshot. Such a directory is still listed to get the current size and time of each entry, but its entries are not matched against the rules again." << std::endl;
+    std::cout << "--jobs (-j) N" << std::endl;
+    std::cout << "  With --create-package: create up to N packages concurrently. Directory scanning threads are shared by all packages. Default is 1." << std::endl;
+    std::cout << "  When more than one package is created, a summary of the time and throughput of each package is printed." << std::endl;
     std::cout << "--make-setup (-m) PACKAGE.bin" << std::endl;
     std::cout << "  Create Visual C++ setup program from PACKAGE.package.bin and package info file PACKAGE.package.info.xml." << std::endl;
+    std::cout << "--list (-l) PACKAGE.bin" << std::endl;
+    std::cout << "  List components and files of PACKAGE.bin by reading only the package index." << std::endl;
+    std::cout << "--component COMPONENT" << std::endl;
+    std::cout << "  List only files of component COMPONENT. Can be given more than once." << std::endl;
+    std::cout << "--filter FILE_PATTERN" << std::endl;
+    std::cout << "  List only files whose path matches FILE_PATTERN, for example '*.dll'. Can be given more than once." << std::endl;
+    std::cout << "--json" << std::endl;
+    std::cout << "  Print listing in JSON format." << std::endl;
+    std::cout << "--diff (-d) A.bin|A.index.xml B.bin|B.index.xml" << std::endl;
+    std::cout << "  Compare package indices A and B and print added, removed, modified and metadata only changed files." << std::endl;
+    std::cout << "--extract (-x) PACKAGE.bin FILE_PATTERN..." << std::endl;
+    std::cout << "  Extract files whose path matches one of the FILE_PATTERNs from PACKAGE.bin without installing the package." << std::endl;
+    std::cout << "--output (-o) DIR" << std::endl;
+    std::cout << "  Set output directory for --extract. Default is the current directory." << std::endl;
+    std::cout << "--verify-package PACKAGE.bin" << std::endl;
+    std::cout << "  Verify SHA-1 digests of the files in PACKAGE.bin without installing the package." << std::endl;
+    std::cout << "--watch PACKAGE.package.xml" << std::endl;
+    std::cout << "  Create package files like --create-package, then watch the source root directory and update the package files after each change until stopped with Ctrl+C." << std::endl;
+    std::cout << "  Only changed directories are scanned again. Every file is read and hashed again each time the package files are written." << std::endl;
 }
 
 class PackageFileContentPositionObserver : public PackageObserver
@@ -90,6 +121,9 @@ void PackageFileContentPositionObserver::StatusChanged(Package* package)
         if (inFileContent)
         {
             inFileContent = false;
+            firstFileContent = true;
+            numBackspaces = 0;
+            prevPercent = -1;
             std::cout << std::endl;
         }
         std::cout << package->GetStatusStr() << std::endl;
@@ -146,10 +180,20 @@ int main(int argc, const char** argv)
         InitApplication();
         Command command = Command::none;
         bool verbose = false;
+        bool useSnapshot = false;
+        int numJobs = 1;
         std::vector<std::string> packagesToCreate;
         std::vector<std::string> packagesToInstall;
         std::vector<std::string> packagesToInstallFromVec;
         std::vector<std::string> setupsToCreate;
+        std::vector<std::string> packagesToList;
+        std::vector<std::string> packagesToDiff;
+        std::string packageToExtract;
+        std::string outputDir;
+        std::vector<std::string> packagesToVerify;
+        std::string packageToWatch;
+        IndexFilter indexFilter;
+        ListFormat listFormat = ListFormat::text;
         Content content = Content::all;
         for (int i = 1; i < argc; ++i)
         {
@@ -189,6 +233,50 @@ int main(int argc, const char** argv)
                 {
                     command = Command::setContent;
                 }
+                else if (arg == "--list")
+                {
+                    command = Command::listPackage;
+                }
+                else if (arg == "--component")
+                {
+                    command = Command::setComponentFilter;
+                }
+                else if (arg == "--filter")
+                {
+                    command = Command::setFileFilter;
+                }
+                else if (arg == "--diff")
+                {
+                    command = Command::diffPackages;
+                }
+                else if (arg == "--extract")
+                {
+                    command = Command::extractFiles;
+                }
+                else if (arg == "--output")
+                {
+                    command = Command::setOutputDir;
+                }
+                else if (arg == "--verify-package")
+                {
+                    command = Command::verifyPackage;
+                }
+                else if (arg == "--watch")
+                {
+                    command = Command::watchPackage;
+                }
+                else if (arg == "--jobs")
+                {
+                    command = Command::setJobs;
+                }
+                else if (arg == "--snapshot")
+                {
+                    useSnapshot = true;
+                }
+                else if (arg == "--json")
+                {
+                    listFormat = ListFormat::json;
+                }
                 else
                 {
                     throw std::runtime_error("unknown option '" + arg + "'");
@@ -231,6 +319,31 @@ int main(int argc, const char** argv)
                             command = Command::makeSetup;
                             break;
                         }
+                        case 'l':
+                        {
+                            command = Command::listPackage;
+                            break;
+                        }
+                        case 'd':
+                        {
+                            command = Command::diffPackages;
+                            break;
+                        }
+                        case 'x':
+                        {
+                            command = Command::extractFiles;
+                            break;
+                        }
+                        case 'o':
+                        {
+                            command = Command::setOutputDir;
+                            break;
+                        }
+                        case 'j':
+                        {
+                            command = Command::setJobs;
+                            break;
+                        }
                         default:
                         {
                             throw std::runtime_error("unknown option '-" + std::string(1, o) + "'");
@@ -286,6 +399,73 @@ int main(int argc, const char** argv)
                         }
                         break;
                     }
+                    case Command::listPackage:
+                    {
+                        packagesToList.push_back(GetFullPath(arg));
+                        break;
+                    }
+                    case Command::setComponentFilter:
+                    {
+                        indexFilter.AddComponent(arg);
+                        break;
+                    }
+                    case Command::setFileFilter:
+                    {
+                        indexFilter.AddPattern(arg);
+                        break;
+                    }
+                    case Command::diffPackages:
+                    {
+                        packagesToDiff.push_back(GetFullPath(arg));
+                        break;
+                    }
+                    case Command::extractFiles:
+                    {
+                        if (packageToExtract.empty())
+                        {
+                            packageToExtract = GetFullPath(arg);
+                        }
+                        else
+                        {
+                            indexFilter.AddPattern(arg);
+                        }
+                        break;
+                    }
+                    case Command::setOutputDir:
+                    {
+                        outputDir = GetFullPath(arg);
+                        break;
+                    }
+                    case Command::verifyPackage:
+                    {
+                        packagesToVerify.push_back(GetFullPath(arg));
+                        break;
+                    }
+                    case Command::watchPackage:
+                    {
+                        if (!packageToWatch.empty())
+                        {
+                            throw std::runtime_error("--watch accepts only one package");
+                        }
+                        packageToWatch = GetFullPath(arg);
+                        break;
+                    }
+                    case Command::setJobs:
+                    {
+                        try
+                        {
+                            numJobs = std::stoi(arg);
+                        }
+                        catch (const std::exception&)
+                        {
+                            numJobs = 0;
+                        }
+                        if (numJobs <= 0)
+                        {
+                            throw std::runtime_error("invalid number of jobs '" + arg + "'");
+                        }
+                        break;
+                    }
                     case Command::none:
                     {
                         throw std::runtime_error("command argument not set");
@@ -293,37 +473,24 @@ int main(int argc, const char** argv)
                 }
             }
         }
-        for (const std::string& packageXmlFilePath : packagesToCreate)
+        if (!packagesToCreate.empty())
         {
-            if (verbose)
+            PackageBuilder builder(packagesToCreate, content, useSnapshot, verbose, numJobs);
+            PackageFileContentPositionObserver observer(PackageFileContentPositionObserver::Kind::write, verbose);
+            builder.SetObserver(&observer);
+            builder.Run();
+            if (packagesToCreate.size() > 1)
             {
-                std::cout << "creating package '" << packageXmlFilePath + "'..." << std::endl;
+                PrintPackageBuildSummary(builder, std::cout);
             }
-            std::unique_ptr<sngxml::dom::Document> packageDoc = sngxml::dom::ReadDocument(packageXmlFilePath);
-            PathMatcher pathMatcher(packageXmlFilePath);
-            std::unique_ptr<Package> package(new Package(pathMatcher, packageDoc.get()));
-            std::string xmlIndexFilePath = Path::ChangeExtension(packageXmlFilePath, ".index.xml");
-            package->WriteIndexToXmlFile(xmlIndexFilePath);
-            if (verbose)
+            int failedCount = builder.FailedCount();
+            if (failedCount == 1 && packagesToCreate.size() == 1)
             {
-                std::cout << "==> " << xmlIndexFilePath << std::endl;
+                throw std::runtime_error(builder.Builds().front().error);
             }
-            std::string packageBinFilePath = Path::ChangeExtension(packageXmlFilePath, ".bin");
+            else if (failedCount > 0)
             {
-                PackageFileContentPositionObserver observer(PackageFileContentPositionObserver::Kind::write, verbose);
-                package->AddObserver(&observer);
-                package->Create(packageBinFilePath, content);
-                package->RemoveObserver(&observer);
-            }
-            if (verbose)
-            {
-                std::cout << "==> " << packageBinFilePath << std::endl;
-            }
-            std::string xmlInfoFilePath = Path::ChangeExtension(packageXmlFilePath, ".info.xml");
-            package->WriteInfoXmlFile(xmlInfoFilePath);
-            if (verbose)
-            {
-                std::cout << "==> " << xmlInfoFilePath << std::endl;
+                throw std::runtime_error(std::to_string(failedCount) + " of " + std::to_string(packagesToCreate.size()) + " packages failed");
             }
         }
         for (const std::string& packageBinFilePath : packagesToInstall)
@@ -394,6 +561,68 @@ int main(int argc, const char** argv)
                 std::cout << "setup for package '" << packageBinFilePath << "' created" << std::endl;
             }
         }
+        for (const std::string& packageBinFilePath : packagesToList)
+        {
+            std::unique_ptr<Package> package(new Package());
+            package->ReadPackageIndex(DataSource::file, packageBinFilePath, nullptr, 0, content);
+            ListPackageIndex(package.get(), indexFilter, listFormat, std::cout);
+        }
+        if (packagesToDiff.size() % 2 != 0)
+        {
+            throw std::runtime_error("--diff needs two package or package index files");
+        }
+        for (int i = 0; i < packagesToDiff.size(); i += 2)
+        {
+            const std::string& leftFilePath = packagesToDiff[i];
+            const std::string& rightFilePath = packagesToDiff[i + 1];
+            if (verbose)
+            {
+                std::cout << "comparing '" << leftFilePath << "' to '" << rightFilePath << "'..." << std::endl;
+            }
+            std::vector<IndexEntry> leftEntries = ReadIndexEntries(leftFilePath);
+            std::vector<IndexEntry> rightEntries = ReadIndexEntries(rightFilePath);
+            PackageIndexDiff diff = DiffIndexEntries(leftEntries, rightEntries);
+            PrintPackageIndexDiff(diff, std::cout);
+        }
+        if (!packageToExtract.empty())
+        {
+            if (indexFilter.Empty())
+            {
+                throw std::runtime_error("--extract needs at least one file pattern");
+            }
+            if (outputDir.empty())
+            {
+                outputDir = GetFullPath(".");
+            }
+            if (verbose)
+            {
+                std::cout << "extracting files from package '" << packageToExtract << "' to directory '" << outputDir << "'..." << std::endl;
+            }
+            ExtractPackageFiles(packageToExtract, indexFilter, outputDir, content, verbose);
+        }
+        bool verificationFailed = false;
+        for (const std::string& packageBinFilePath : packagesToVerify)
+        {
+            if (verbose)
+            {
+                std::cout << "verifying package '" << packageBinFilePath << "'..." << std::endl;
+            }
+            PackageVerification verification = VerifyPackage(packageBinFilePath, content);
+            PrintPackageVerification(packageBinFilePath, verification, std::cout);
+            if (!verification.failures.empty())
+            {
+                verificationFailed = true;
+            }
+        }
+        if (verificationFailed)
+        {
+            throw std::runtime_error("package verification failed");
+        }
+        if (!packageToWatch.empty())
+        {
+            PackageWatcher watcher(packageToWatch, content, verbose);
+            watcher.Run();
+        }
     }
     catch (const std::exception& ex)
     {
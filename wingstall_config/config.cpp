@@ -6,10 +6,12 @@
 #include <wingstall_config/config.hpp>
 #include <sngxml/dom/Parser.hpp>
 #include <sngxml/dom/Element.hpp>
+#include <sngxml/dom/DocumentCache.hpp>
 #include <soulng/util/Path.hpp>
 #include <soulng/util/Unicode.hpp>
 #include <boost/filesystem.hpp>
 #include <iostream>
+#include <mutex>
 
 namespace wingstall { namespace config {
 
@@ -62,19 +64,25 @@ std::unique_ptr<sngxml::dom::Document> ConfigurationDocument()
         {
             operation = "read/write";
             configDoc = sngxml::dom::ReadDocument(ConfigFilePath());
+            bool changed = false;
             std::u32string vcVarsFilePath = configDoc->DocumentElement()->GetAttribute(U"vcVarsFilePath");
             if (vcVarsFilePath.empty())
             {
                 configDoc->DocumentElement()->SetAttribute(U"vcVarsFilePath", ToUtf32(defaultVCVarsFilePath));
+                changed = true;
             }
             std::u32string vcPlatformToolset = configDoc->DocumentElement()->GetAttribute(U"vcPlatformToolset");
             if (vcPlatformToolset.empty())
             {
                 configDoc->DocumentElement()->SetAttribute(U"vcPlatformToolset", ToUtf32(defaultVCPlatformToolset));
+                changed = true;
+            }
+            if (changed)
+            {
+                std::ofstream configFile(ConfigFilePath());
+                CodeFormatter formatter(configFile);
+                configDoc->Write(formatter);
             }
-            std::ofstream configFile(ConfigFilePath());
-            CodeFormatter formatter(configFile);
-            configDoc->Write(formatter);
         }
         else
         {
@@ -99,6 +107,36 @@ std::unique_ptr<sngxml::dom::Document> ConfigurationDocument()
     return std::unique_ptr<sngxml::dom::Document>();
 }
 
+// The settings are extracted from the configuration document once and kept for as long as the document is unchanged.
+// The stamp is taken before the document is read, so if ConfigurationDocument has to add missing settings to the file, the file is read once more the next time.
+
+std::shared_ptr<const ConfigurationSettings> GetConfigurationSettings()
+{
+    static std::mutex mtx;
+    static std::shared_ptr<const ConfigurationSettings> settings;
+    static sngxml::dom::FileStamp settingsStamp;
+    std::lock_guard<std::mutex> lock(mtx);
+    sngxml::dom::FileStamp stamp = sngxml::dom::GetFileStamp(ConfigFilePath());
+    if (settings && sngxml::dom::IsUnchanged(settingsStamp, stamp))
+    {
+        return settings;
+    }
+    std::unique_ptr<sngxml::dom::Document> configDoc = ConfigurationDocument();
+    if (!configDoc)
+    {
+        settings.reset();
+        return settings;
+    }
+    std::shared_ptr<ConfigurationSettings> newSettings(new ConfigurationSettings());
+    newSettings->boostIncludeDir = BoostIncludeDir(configDoc.get());
+    newSettings->boostLibDir = BoostLibDir(configDoc.get());
+    newSettings->vcVarsFilePath = VCVarsFilePath(configDoc.get());
+    newSettings->vcPlatformToolset = VCPlatformToolset(configDoc.get());
+    settings = newSettings;
+    settingsStamp = stamp;
+    return settings;
+}
+
 std::string BoostIncludeDir(sngxml::dom::Document* configDocument)
 {
     return ToUtf8(configDocument->DocumentElement()->GetAttribute(U"boostIncludeDir"));
@@ -17,6 +17,16 @@ std::string DefaultBoostLibDir();
 std::string DefaultVCVarsFilePath();
 std::string DefaultVCPlatformToolset();
 std::unique_ptr<sngxml::dom::Document> ConfigurationDocument();
+
+struct ConfigurationSettings
+{
+    std::string boostIncludeDir;
+    std::string boostLibDir;
+    std::string vcVarsFilePath;
+    std::string vcPlatformToolset;
+};
+
+std::shared_ptr<const ConfigurationSettings> GetConfigurationSettings();
 std::string BoostIncludeDir(sngxml::dom::Document* configDocument);
 std::string BoostLibDir(sngxml::dom::Document* configDocument);
 std::string VCVarsFilePath(sngxml::dom::Document* configDocument);
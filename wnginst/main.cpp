@@ -1,3 +1,4 @@
+#include <soulng/rex/FilePattern.hpp>
 #include <soulng/rex/Match.hpp>
 #include <soulng/util/BinaryStreamReader.hpp>
 #include <soulng/util/BinaryStreamWriter.hpp>
@@ -142,6 +143,7 @@ int main(int argc, const char** argv)
                     if (boost::filesystem::exists(directory))
                     {
                         std::string fileMask = Path::GetFileName(path);
+                        std::shared_ptr<const FilePatternMatcher> fileMaskMatcher = GetCachedFilePatternMatcher(ToUtf32(fileMask));
                         boost::filesystem::directory_iterator it(directory);
                         while (it != boost::filesystem::directory_iterator())
                         {
@@ -149,7 +151,7 @@ int main(int argc, const char** argv)
                             if (boost::filesystem::is_regular_file(entry.path()))
                             {
                                 std::string fileName = Path::GetFileName(entry.path().generic_string());
-                                if (FilePatternMatch(ToUtf32(fileName), ToUtf32(fileMask)))
+                                if (fileMaskMatcher->Match(fileName))
                                 {
                                     std::string path = Path::Combine(directory, fileName);
                                     paths.push_back(path);
@@ -0,0 +1,252 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xml/XmlParserInterface.hpp>
+#include <sngxml/xml/XmlScan.hpp>
+#include <soulng/util/InitDone.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+void InitApplication()
+{
+    soulng::util::Init();
+}
+
+// Makes a document shaped like a *.index.xml file: indented component, directory and file elements whose attributes hold names, sizes, times and hashes.
+
+std::string MakeIndexDocument(int numFiles)
+{
+    std::mt19937 random(49);
+    std::stringstream s;
+    s << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    s << "<packageIndex name=\"benchmark\" sourceRootDir=\"C:/work/benchmark\" targetRootDir=\"C:/Program Files/benchmark\">\n";
+    for (int i = 0; i < numFiles; ++i)
+    {
+        if (i % 1000 == 0)
+        {
+            if (i > 0)
+            {
+                s << "  </directory>\n </component>\n";
+            }
+            s << " <component name=\"component" << i / 1000 << "\">\n";
+            s << "  <directory name=\"directory" << i / 1000 << "\" time=\"2022-03-14T12:00:00\">\n";
+        }
+        s << "   <file hash=\"";
+        for (int j = 0; j < 40; ++j)
+        {
+            s << "0123456789abcdef"[random() % 16];
+        }
+        s << "\" name=\"source_file_" << i << ".cpp\" size=\"" << random() % 1000000 << "\" time=\"2022-03-14T12:" << std::setw(2) << std::setfill('0') << random() % 60 << ":00\"/>\n";
+    }
+    if (numFiles > 0)
+    {
+        s << "  </directory>\n </component>\n";
+    }
+    s << "</packageIndex>\n";
+    return s.str();
+}
+
+// Makes a document of long text runs with an occasional entity reference, such as a description or a license.
+
+std::string MakeTextDocument(int numParagraphs)
+{
+    std::mt19937 random(49);
+    const char* words[] = { "package", "installer", "component", "directory", "file", "the", "of", "and", "to", "is", "in", "compressed", "setup", "wingstall" };
+    std::stringstream s;
+    s << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<text>\n";
+    for (int i = 0; i < numParagraphs; ++i)
+    {
+        s << "  <p>";
+        for (int j = 0; j < 200; ++j)
+        {
+            if (j > 0)
+            {
+                s << (j % 50 == 0 ? "\n    " : " ");
+            }
+            s << words[random() % (sizeof(words) / sizeof(words[0]))];
+        }
+        s << " &amp; more.</p>\n";
+    }
+    s << "</text>\n";
+    return s.str();
+}
+
+// Scalar versions of the scanning functions, for checking and for comparison.
+
+const char* ScanCharDataScalar(const char* p, const char* end)
+{
+    while (p != end && *p != '<' && *p != '&' && static_cast<unsigned char>(*p) < 0x80)
+    {
+        ++p;
+    }
+    return p;
+}
+
+const char* ScanAttributeValueScalar(const char* p, const char* end, char quote)
+{
+    while (p != end && *p != quote && *p != '<' && *p != '&' && static_cast<unsigned char>(*p) < 0x80)
+    {
+        ++p;
+    }
+    return p;
+}
+
+const char* ScanSpaceScalar(const char* p, const char* end)
+{
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    {
+        ++p;
+    }
+    return p;
+}
+
+struct ScanResult
+{
+    ScanResult() : seconds(0), stops(0), checksum(0) {}
+    double seconds;
+    int64_t stops;
+    uint64_t checksum;
+};
+
+// Scans the whole document with the function, stepping over each byte where a run ends, or over each run of other bytes when scanning white space.
+// The number and positions of the stops identify the result.
+
+template<typename ScanFn>
+ScanResult TimeScan(const std::string& document, ScanFn scan, bool skipOtherBytes)
+{
+    ScanResult result;
+    const char* begin = document.data();
+    const char* end = document.data() + document.size();
+    auto start = std::chrono::steady_clock::now();
+    const char* p = begin;
+    while (p != end)
+    {
+        p = scan(p, end);
+        if (p != end)
+        {
+            ++result.stops;
+            result.checksum = result.checksum * 31 + static_cast<uint64_t>(p - begin);
+            ++p;
+            if (skipOtherBytes)
+            {
+                while (p != end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                {
+                    ++p;
+                }
+            }
+        }
+    }
+    auto finish = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(finish - start).count();
+    return result;
+}
+
+std::string Throughput(double bytes, double seconds)
+{
+    std::stringstream s;
+    s << std::fixed << std::setprecision(0) << std::setw(7) << bytes / seconds / (1024 * 1024) << " MB/s";
+    return s.str();
+}
+
+const int numRounds = 5;
+
+template<typename ScanFn, typename ScalarScanFn>
+void BenchmarkScan(const std::string& name, const std::string& document, ScanFn scan, ScalarScanFn scalarScan, bool skipOtherBytes)
+{
+    ScanResult best;
+    ScanResult bestScalar;
+    for (int round = 0; round < numRounds; ++round)
+    {
+        ScanResult result = TimeScan(document, scan, skipOtherBytes);
+        ScanResult scalarResult = TimeScan(document, scalarScan, skipOtherBytes);
+        if (result.stops != scalarResult.stops || result.checksum != scalarResult.checksum)
+        {
+            throw std::runtime_error(name + " stops at different positions than the scalar version");
+        }
+        if (round == 0 || result.seconds < best.seconds)
+        {
+            best = result;
+        }
+        if (round == 0 || scalarResult.seconds < bestScalar.seconds)
+        {
+            bestScalar = scalarResult;
+        }
+    }
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << Throughput(document.size(), best.seconds) << ", scalar " << Throughput(document.size(), bestScalar.seconds) <<
+        ", " << best.stops << " stops" << std::endl;
+}
+
+class CountingContentHandler : public sngxml::xml::XmlContentHandler
+{
+public:
+    CountingContentHandler() : events(0), textLength(0) {}
+    void StartElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName, const sngxml::xml::Attributes& attributes,
+        const soulng::lexer::SourcePos& sourcePos) override { ++events; }
+    void EndElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName) override { ++events; }
+    void Text(const std::u32string& text) override { ++events; textLength += text.length(); }
+    int64_t Events() const { return events; }
+    int64_t TextLength() const { return textLength; }
+private:
+    int64_t events;
+    int64_t textLength;
+};
+
+void BenchmarkParse(const std::string& document)
+{
+    double best = 0;
+    int64_t events = 0;
+    for (int round = 0; round < numRounds; ++round)
+    {
+        CountingContentHandler contentHandler;
+        auto start = std::chrono::steady_clock::now();
+        sngxml::xml::ParseXmlContent(document, "benchmark.index.xml", &contentHandler, sngxml::xml::Flags::streaming);
+        auto finish = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(finish - start).count();
+        if (round == 0 || seconds < best)
+        {
+            best = seconds;
+        }
+        events = contentHandler.Events();
+    }
+    std::cout << "  " << std::left << std::setw(20) << "streaming parse" << std::right << Throughput(document.size(), best) << ", " << events << " events" << std::endl;
+}
+
+void Benchmark(const std::string& title, const std::string& document)
+{
+    std::cout << title << ", " << document.size() / (1024 * 1024) << " MB" << std::endl;
+    BenchmarkScan("ScanCharData", document, sngxml::xml::ScanCharData, ScanCharDataScalar, false);
+    BenchmarkScan("ScanAttributeValue", document, [](const char* p, const char* end) { return sngxml::xml::ScanAttributeValue(p, end, '"'); },
+        [](const char* p, const char* end) { return ScanAttributeValueScalar(p, end, '"'); }, false);
+    BenchmarkScan("ScanSpace", document, sngxml::xml::ScanSpace, ScanSpaceScalar, true);
+    BenchmarkParse(document);
+}
+
+// Runs the scanning functions over a generated index document and a generated text document, checks that they stop where the scalar versions stop,
+// and prints their throughput next to the scalar versions and the throughput of the streaming parser. The index document has 200000 files by default.
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        InitApplication();
+        int numFiles = 200000;
+        if (argc > 1)
+        {
+            numFiles = std::stoi(argv[1]);
+        }
+        Benchmark("index document of " + std::to_string(numFiles) + " files", MakeIndexDocument(numFiles));
+        Benchmark("text document", MakeTextDocument(numFiles / 10));
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xml/XmlParser.hpp>
+#include <sngxml/xml/Rules.hpp>
+#include <soulng/lexer/TrivialLexer.hpp>
+#include <soulng/util/InitDone.hpp>
+#include <soulng/util/MappedInputFile.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+using namespace soulng::util;
+using namespace soulng::unicode;
+
+void InitApplication()
+{
+    soulng::util::Init();
+}
+
+// Records the events reported by the XML processor and the error that ends the parse, if any, as text.
+
+class EventLog : public sngxml::xml::XmlContentHandler
+{
+public:
+    void StartDocument() override { Add("start document"); }
+    void EndDocument() override { Add("end document"); }
+    void Version(const std::u32string& xmlVersion) override { Add("version " + ToUtf8(xmlVersion)); }
+    void Standalone(bool standalone) override { Add(std::string("standalone ") + (standalone ? "yes" : "no")); }
+    void Encoding(const std::u32string& encoding) override { Add("encoding " + ToUtf8(encoding)); }
+    void Text(const std::u32string& text) override { Add("text " + ToUtf8(text)); }
+    void Comment(const std::u32string& comment) override { Add("comment " + ToUtf8(comment)); }
+    void PI(const std::u32string& target, const std::u32string& data) override { Add("pi " + ToUtf8(target) + " " + ToUtf8(data)); }
+    void CDataSection(const std::u32string& cdata) override { Add("cdata " + ToUtf8(cdata)); }
+    void StartElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName, const sngxml::xml::Attributes& attributes,
+        const soulng::lexer::SourcePos& sourcePos) override;
+    void EndElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName) override;
+    void SkippedEntity(const std::u32string& entityName) override { Add("skipped entity " + ToUtf8(entityName)); }
+    void Error(const std::string& message) { Add("error " + message); }
+    const std::string& Events() const { return events; }
+private:
+    void Add(const std::string& event);
+    std::string events;
+};
+
+void EventLog::StartElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName, const sngxml::xml::Attributes& attributes,
+    const soulng::lexer::SourcePos& sourcePos)
+{
+    std::string event = "start element " + ToUtf8(namespaceUri) + " " + ToUtf8(localName) + " " + ToUtf8(qualifiedName) + " at " + std::to_string(sourcePos.line) + ":" +
+        std::to_string(sourcePos.col);
+    for (const sngxml::xml::Attribute& attribute : attributes)
+    {
+        event.append(" " + ToUtf8(attribute.QualifiedName()) + "=" + ToUtf8(attribute.Value()));
+    }
+    Add(event);
+}
+
+void EventLog::EndElement(const std::u32string& namespaceUri, const std::u32string& localName, const std::u32string& qualifiedName)
+{
+    Add("end element " + ToUtf8(namespaceUri) + " " + ToUtf8(localName) + " " + ToUtf8(qualifiedName));
+}
+
+void EventLog::Add(const std::string& event)
+{
+    events.append(event).append("\n");
+}
+
+// Parses the content the way ParseXmlContent does. A window size of zero keeps all tokens in memory.
+
+std::string Parse(const std::u32string& content, int64_t windowSize)
+{
+    EventLog log;
+    try
+    {
+        TrivialLexer xmlLexer(content, "test.xml", 0);
+        xmlLexer.SetFlag(soulng::lexer::LexerFlags::farthestError);
+        if (windowSize > 0)
+        {
+            xmlLexer.SetTokenWindow(windowSize);
+        }
+        xmlLexer.SetRuleNameVecPtr(GetRuleNameVecPtr());
+        sngxml::xml::XmlProcessor xmlProcessor(xmlLexer, &log);
+        XmlParser::Parse(xmlLexer, &xmlProcessor);
+    }
+    catch (const std::exception& ex)
+    {
+        log.Error(ex.what());
+    }
+    return log.Events();
+}
+
+struct Results
+{
+    Results() : checks(0), failures(0) {}
+    int checks;
+    int failures;
+};
+
+// The smallest windows make the parser backtrack to released tokens as often as possible.
+
+const int64_t testWindowSizes[] = { 1, 2 };
+
+void Check(Results& results, const std::u32string& content, const std::string& description)
+{
+    std::string expected = Parse(content, 0);
+    for (int64_t windowSize : testWindowSizes)
+    {
+        ++results.checks;
+        std::string actual = Parse(content, windowSize);
+        if (actual != expected)
+        {
+            ++results.failures;
+            std::cout << "FAILED: " << description << " with window size " << windowSize << std::endl;
+            std::cout << "expected:\n" << expected << "actual:\n" << actual << std::endl;
+        }
+    }
+}
+
+const char* fixedDocuments[] =
+{
+    "<a/>",
+    "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>\n<a x='1' y=\"2\">text</a>",
+    "<?xml version='1.0'?><!-- comment --><?target data?><a><b/><c>x</c></a>",
+    "<!DOCTYPE a [\n<!ELEMENT a (#PCDATA|b)*>\n<!ATTLIST a x CDATA #IMPLIED>\n<!ENTITY e \"replacement\">\n]>\n<a x=\"&e;\">&e; &amp; &lt; &#65; &#x42;</a>",
+    "<!DOCTYPE a SYSTEM \"a.dtd\"><a/>",
+    "<!DOCTYPE a PUBLIC \"-//A//DTD A//EN\" \"a.dtd\"><a/>",
+    "<a><![CDATA[ <not> &markup; ]]></a>",
+    "<a xmlns=\"urn:a\" xmlns:b=\"urn:b\"><b:c b:d=\"e\"/></a>",
+    "<a>\r\n  <b>\r\n  </b>\r\n</a>\r\n",
+    "<a>line 1\nline 2\nline 3</a>",
+    "<a>&unknown;</a>",
+    "<a><b></a>",
+    "<a",
+    "<a x=\"1></a>",
+    "<a></b>",
+    "<a>&#xZZ;</a>",
+    "text",
+    "<?xml version=\"1.0\"?>",
+    "<a/><b/>",
+    "<a><!-- unterminated comment </a>"
+};
+
+const char* names[] = { "a", "b", "item", "x:y", "long_element-name.1" };
+const char* texts[] = { "text", " ", "\n", "&amp;", "&lt;&gt;", "&#65;", "&#x3b1;", "&quot;&apos;", "multiple words here", "\xce\xb1\xce\xb2" };
+
+std::string GenerateElement(std::mt19937& random, int depth)
+{
+    std::string name = names[random() % (sizeof(names) / sizeof(names[0]))];
+    std::string element = "<" + name;
+    int numAttributes = random() % 3;
+    for (int i = 0; i < numAttributes; ++i)
+    {
+        char quote = random() % 2 == 0 ? '"' : '\'';
+        element.append(" attr" + std::to_string(i) + "=" + quote + texts[random() % (sizeof(texts) / sizeof(texts[0]))] + quote);
+    }
+    if (random() % 4 == 0)
+    {
+        return element + "/>";
+    }
+    element.append(">");
+    int numChildren = depth < 4 ? random() % 5 : 0;
+    for (int i = 0; i < numChildren; ++i)
+    {
+        switch (random() % 6)
+        {
+            case 0: element.append(GenerateElement(random, depth + 1)); break;
+            case 1: element.append(GenerateElement(random, depth + 1)); break;
+            case 2: element.append(texts[random() % (sizeof(texts) / sizeof(texts[0]))]); break;
+            case 3: element.append("<!--" + std::string(texts[random() % 3]) + "-->"); break;
+            case 4: element.append("<?pi " + std::string(texts[random() % 3]) + "?>"); break;
+            case 5: element.append("<![CDATA[" + std::string(texts[random() % (sizeof(texts) / sizeof(texts[0]))]) + "]]>"); break;
+        }
+    }
+    return element + "</" + name + ">";
+}
+
+std::string GenerateDocument(std::mt19937& random)
+{
+    std::string document;
+    if (random() % 2 == 0)
+    {
+        document.append("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+    }
+    if (random() % 3 == 0)
+    {
+        document.append("<!-- prolog -->\n");
+    }
+    document.append(GenerateElement(random, 0));
+    return document;
+}
+
+// Deletes, inserts or truncates at a random position, so that the parser fails at different points and the farthest error positions are compared too.
+// At least the first character is kept: the lexer does not handle empty content.
+
+std::u32string Corrupt(std::mt19937& random, const std::u32string& document)
+{
+    std::u32string corrupted = document;
+    size_t pos = 1 + random() % (corrupted.length() - 1);
+    switch (random() % 3)
+    {
+        case 0: corrupted.erase(pos, 1); break;
+        case 1: corrupted.insert(pos, 1, U"<>&\"'/!?"[random() % 8]); break;
+        case 2: corrupted.erase(pos); break;
+    }
+    return corrupted;
+}
+
+void TestFixedDocuments(Results& results)
+{
+    for (const char* document : fixedDocuments)
+    {
+        Check(results, ToUtf32(std::string(document)), "document '" + std::string(document) + "'");
+    }
+}
+
+void TestRandomDocuments(Results& results)
+{
+    std::mt19937 random(42);
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::u32string document = ToUtf32(GenerateDocument(random));
+        Check(results, document, "random document " + std::to_string(i) + " '" + ToUtf8(document) + "'");
+        std::u32string corrupted = Corrupt(random, document);
+        Check(results, corrupted, "corrupted random document " + std::to_string(i) + " '" + ToUtf8(corrupted) + "'");
+    }
+}
+
+void TestFile(Results& results, const std::string& filePath)
+{
+    MappedInputFile file(filePath);
+    std::string content(file.Begin(), file.End());
+    Check(results, ToUtf32(content), "file '" + filePath + "'");
+}
+
+// Parses each document with all tokens kept in memory and with a window of one and two tokens, and compares the content handler events and errors.
+// XML files given as arguments are compared too.
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        InitApplication();
+        Results results;
+        TestFixedDocuments(results);
+        TestRandomDocuments(results);
+        for (int i = 1; i < argc; ++i)
+        {
+            TestFile(results, argv[i]);
+        }
+        std::cout << results.checks << " checks, " << results.failures << " failures" << std::endl;
+        if (results.failures > 0)
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
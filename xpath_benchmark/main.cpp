@@ -0,0 +1,189 @@
+// =================================
+// Copyright (c) 2022 Seppo Laakko
+// Distributed under the MIT license
+// =================================
+
+#include <sngxml/xpath/InitDone.hpp>
+#include <sngxml/xpath/XPathEvaluate.hpp>
+#include <sngxml/dom/Document.hpp>
+#include <sngxml/dom/Element.hpp>
+#include <soulng/util/InitDone.hpp>
+#include <soulng/util/Unicode.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+using namespace soulng::unicode;
+
+void InitApplication()
+{
+    soulng::util::Init();
+    sngxml::xpath::Init();
+}
+
+const int filesPerDirectory = 50;
+const int directoriesPerComponent = 20;
+
+// Makes a document shaped like a package index: components contain directories of files, and each directory has a subdirectory with one file.
+
+std::unique_ptr<sngxml::dom::Document> MakeIndexDocument(int numFiles)
+{
+    std::unique_ptr<sngxml::dom::Document> document(new sngxml::dom::Document());
+    sngxml::dom::Element* indexElement = new sngxml::dom::Element(U"packageIndex");
+    indexElement->SetAttribute(U"name", U"benchmark");
+    document->AppendChild(std::unique_ptr<sngxml::dom::Node>(indexElement));
+    sngxml::dom::Element* componentElement = nullptr;
+    sngxml::dom::Element* directoryElement = nullptr;
+    for (int i = 0; i < numFiles; ++i)
+    {
+        if (i % (filesPerDirectory * directoriesPerComponent) == 0)
+        {
+            componentElement = new sngxml::dom::Element(U"component");
+            componentElement->SetAttribute(U"name", U"c" + ToUtf32(std::to_string(i / (filesPerDirectory * directoriesPerComponent))));
+            indexElement->AppendChild(std::unique_ptr<sngxml::dom::Node>(componentElement));
+        }
+        if (i % filesPerDirectory == 0)
+        {
+            directoryElement = new sngxml::dom::Element(U"directory");
+            directoryElement->SetAttribute(U"name", U"d" + ToUtf32(std::to_string(i / filesPerDirectory)));
+            componentElement->AppendChild(std::unique_ptr<sngxml::dom::Node>(directoryElement));
+            sngxml::dom::Element* subdirectoryElement = new sngxml::dom::Element(U"directory");
+            subdirectoryElement->SetAttribute(U"name", U"sub");
+            sngxml::dom::Element* subdirectoryFileElement = new sngxml::dom::Element(U"file");
+            subdirectoryFileElement->SetAttribute(U"name", U"s" + ToUtf32(std::to_string(i / filesPerDirectory)));
+            subdirectoryElement->AppendChild(std::unique_ptr<sngxml::dom::Node>(subdirectoryFileElement));
+            directoryElement->AppendChild(std::unique_ptr<sngxml::dom::Node>(subdirectoryElement));
+        }
+        sngxml::dom::Element* fileElement = new sngxml::dom::Element(U"file");
+        fileElement->SetAttribute(U"name", U"f" + ToUtf32(std::to_string(i)) + U".cpp");
+        fileElement->SetAttribute(U"size", ToUtf32(std::to_string(i)));
+        directoryElement->AppendChild(std::unique_ptr<sngxml::dom::Node>(fileElement));
+    }
+    return document;
+}
+
+struct Query
+{
+    const char* expression;
+    int (*expectedLength)(int numFiles);
+};
+
+int Directories(int numFiles)
+{
+    return (numFiles + filesPerDirectory - 1) / filesPerDirectory;
+}
+
+// Each query builds node sets that grow with the document: the descendant axis, a union of two large sets, a child path and a predicate.
+
+Query queries[] =
+{
+    { "//file", [](int numFiles) { return numFiles + Directories(numFiles); } },
+    { "/packageIndex/component/directory/file", [](int numFiles) { return numFiles; } },
+    { "//directory/file", [](int numFiles) { return numFiles + Directories(numFiles); } },
+    { "//directory | //file", [](int numFiles) { return numFiles + 3 * Directories(numFiles); } },
+    { "//directory[@name = 'sub']/file", [](int numFiles) { return Directories(numFiles); } }
+};
+
+const int numRounds = 3;
+
+// Returns the best time of the rounds in seconds.
+
+double TimeQuery(const Query& query, sngxml::dom::Document* document, int numFiles)
+{
+    double best = 0;
+    for (int round = 0; round < numRounds; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<sngxml::xpath::XPathObject> result = sngxml::xpath::Evaluate(ToUtf32(std::string(query.expression)), document);
+        auto end = std::chrono::steady_clock::now();
+        if (result->Type() != sngxml::xpath::XPathObjectType::nodeSet)
+        {
+            throw std::runtime_error("query '" + std::string(query.expression) + "' did not return a node set");
+        }
+        int length = static_cast<sngxml::xpath::XPathNodeSet*>(result.get())->Length();
+        if (length != query.expectedLength(numFiles))
+        {
+            throw std::runtime_error("query '" + std::string(query.expression) + "' returned " + std::to_string(length) + " nodes, " + std::to_string(query.expectedLength(numFiles)) +
+                " expected");
+        }
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (round == 0 || seconds < best)
+        {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+// With linear scaling the time per file stays about the same when the document grows. Small documents fit the caches better,
+// so the time per file is allowed to grow by this factor between the smallest and the largest document.
+
+const double maxTimePerFileGrowth = 4.0;
+
+// Runs each query on documents of 25000 files and up, doubling the number of files until the given maximum, which is 400000 by default.
+// Prints the time and the time per file for each size, and fails if the time per file grows more than linear scaling allows.
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        InitApplication();
+        int maxFiles = 400000;
+        if (argc > 1)
+        {
+            maxFiles = std::stoi(argv[1]);
+        }
+        std::vector<int> sizes;
+        for (int numFiles = 25000; numFiles <= maxFiles; numFiles *= 2)
+        {
+            sizes.push_back(numFiles);
+        }
+        if (sizes.empty())
+        {
+            throw std::runtime_error("maximum number of files must be at least 25000");
+        }
+        std::vector<std::unique_ptr<sngxml::dom::Document>> documents;
+        for (int numFiles : sizes)
+        {
+            documents.push_back(MakeIndexDocument(numFiles));
+        }
+        bool linear = true;
+        for (const Query& query : queries)
+        {
+            std::cout << query.expression << std::endl;
+            double firstTimePerFile = 0;
+            double lastTimePerFile = 0;
+            for (int i = 0; i < sizes.size(); ++i)
+            {
+                double seconds = TimeQuery(query, documents[i].get(), sizes[i]);
+                double timePerFile = seconds / sizes[i];
+                if (i == 0)
+                {
+                    firstTimePerFile = timePerFile;
+                }
+                lastTimePerFile = timePerFile;
+                std::cout << "  " << std::setw(8) << sizes[i] << " files: " << std::fixed << std::setprecision(3) << std::setw(9) << seconds * 1000 << " ms, " <<
+                    std::setprecision(1) << std::setw(7) << timePerFile * 1e9 << " ns/file" << std::endl;
+            }
+            double growth = lastTimePerFile / firstTimePerFile;
+            std::cout << "  time per file grows " << std::setprecision(2) << growth << " times" << std::endl;
+            if (growth > maxTimePerFileGrowth)
+            {
+                std::cout << "  NOT LINEAR" << std::endl;
+                linear = false;
+            }
+        }
+        sngxml::xpath::Done();
+        if (!linear)
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}